@@ -83,25 +83,7 @@ struct SystemInfo {
 
 SystemInfo system_info();
 
-using ThreadId = uint32_t;
-using ThreadHandle = void*;
-using ThreadContext = void*;
-
-/// @brief Executes a function while all other threads are frozen. Also allows for visiting each frozen thread and
-/// modifying it's context.
-/// @param run_fn The function to run while all other threads are frozen.
-/// @param visit_fn The function that will be called for each frozen thread.
-/// @note The visit function will be called in the order that the threads were frozen.
-/// @note The visit function will be called before the run function.
-/// @note Keep the logic inside run_fn and visit_fn as simple as possible to avoid deadlocks.
-void execute_while_frozen(const std::function<void()>& run_fn,
-    const std::function<void(ThreadId, ThreadHandle, ThreadContext)>& visit_fn = {});
-
-/// @brief Will modify the context of a thread's IP to point to a new address if its IP is at the old address.
-/// @param ctx The thread context to modify.
-/// @param old_ip The old IP address.
-/// @param new_ip The new IP address.
-void fix_ip(ThreadContext ctx, uint8_t* old_ip, uint8_t* new_ip);
+// execute_while_frozen and fix_ip are declared in safetyhook/utility.hpp so they can be used to batch hook changes.
 
 } // namespace safetyhook
 
@@ -164,6 +146,31 @@ std::shared_ptr<Allocator> Allocator::create() {
     return std::shared_ptr<Allocator>{new Allocator{}};
 }
 
+std::expected<std::shared_ptr<Allocator>, Allocator::Error> Allocator::create_arena(
+    uint8_t* near_address, size_t size, size_t alignment) {
+    auto allocator = create();
+    allocator->m_alignment = std::max<size_t>(alignment, 1);
+
+    // Regions start on the allocation granularity and every slice is a multiple of the alignment, so slices stay
+    // aligned without any padding bookkeeping.
+    const auto arena_size = align_up(std::max<size_t>(size, 1), system_info().allocation_granularity);
+    const auto arena_address = allocate_nearby_memory({near_address}, arena_size, 0x7FFF'FFFF);
+
+    if (!arena_address) {
+        return std::unexpected{arena_address.error()};
+    }
+
+    auto& memory = allocator->m_memory.emplace_back(new Memory);
+
+    memory->address = *arena_address;
+    memory->size = arena_size;
+    memory->freelist = std::make_unique<FreeNode>();
+    memory->freelist->start = *arena_address;
+    memory->freelist->end = *arena_address + arena_size;
+
+    return allocator;
+}
+
 std::expected<Allocation, Allocator::Error> Allocator::allocate(size_t size) {
     return allocate_near({}, size, std::numeric_limits<size_t>::max());
 }
@@ -181,16 +188,19 @@ void Allocator::free(uint8_t* address, size_t size) {
 
 std::expected<Allocation, Allocator::Error> Allocator::internal_allocate_near(
     const std::vector<uint8_t*>& desired_addresses, size_t size, size_t max_distance) {
+    // The Allocation keeps the requested size, only the space taken from the freelist is rounded up.
+    const auto slice_size = align_up(size, m_alignment);
+
     // First search through our list of allocations for a free block that is large
     // enough.
     for (const auto& allocation : m_memory) {
-        if (allocation->size < size) {
+        if (allocation->size < slice_size) {
             continue;
         }
 
         for (auto node = allocation->freelist.get(); node != nullptr; node = node->next.get()) {
             // Enough room?
-            if (static_cast<size_t>(node->end - node->start) < size) {
+            if (static_cast<size_t>(node->end - node->start) < slice_size) {
                 continue;
             }
 
@@ -201,14 +211,14 @@ std::expected<Allocation, Allocator::Error> Allocator::internal_allocate_near(
                 continue;
             }
 
-            node->start += size;
+            node->start += slice_size;
 
             return Allocation{shared_from_this(), address, size};
         }
     }
 
     // If we didn't find a free block, we need to allocate a new one.
-    auto allocation_size = align_up(size, system_info().allocation_granularity);
+    auto allocation_size = align_up(slice_size, system_info().allocation_granularity);
     auto allocation_address = allocate_nearby_memory(desired_addresses, allocation_size, max_distance);
 
     if (!allocation_address) {
@@ -220,13 +230,15 @@ std::expected<Allocation, Allocator::Error> Allocator::internal_allocate_near(
     allocation->address = *allocation_address;
     allocation->size = allocation_size;
     allocation->freelist = std::make_unique<FreeNode>();
-    allocation->freelist->start = *allocation_address + size;
+    allocation->freelist->start = *allocation_address + slice_size;
     allocation->freelist->end = *allocation_address + allocation_size;
 
     return Allocation{shared_from_this(), *allocation_address, size};
 }
 
 void Allocator::internal_free(uint8_t* address, size_t size) {
+    size = align_up(size, m_alignment);
+
     for (const auto& allocation : m_memory) {
         if (allocation->address > address || allocation->address + allocation->size < address) {
             continue;
@@ -381,8 +393,8 @@ InlineHook create_inline(void* target, void* destination) {
     }
 }
 
-MidHook create_mid(void* target, MidHookFn destination) {
-    if (auto hook = MidHook::create(target, destination)) {
+MidHook create_mid(void* target, MidHookFn destination, MidHook::Flags flags) {
+    if (auto hook = MidHook::create(Allocator::global(), target, destination, flags)) {
         return std::move(*hook);
     } else {
         return {};
@@ -531,6 +543,11 @@ std::expected<InlineHook, InlineHook::Error> InlineHook::create(void* target, vo
 
 std::expected<InlineHook, InlineHook::Error> InlineHook::create(
     const std::shared_ptr<Allocator>& allocator, void* target, void* destination) {
+    return create(allocator, target, destination, Default);
+}
+
+std::expected<InlineHook, InlineHook::Error> InlineHook::create(
+    const std::shared_ptr<Allocator>& allocator, void* target, void* destination, Flags flags) {
     InlineHook hook{};
 
     if (const auto setup_result =
@@ -539,6 +556,12 @@ std::expected<InlineHook, InlineHook::Error> InlineHook::create(
         return std::unexpected{setup_result.error()};
     }
 
+    if (!(flags & StartDisabled)) {
+        if (auto enable_result = hook.enable(); !enable_result) {
+            return std::unexpected{enable_result.error()};
+        }
+    }
+
     return hook;
 }
 
@@ -557,10 +580,14 @@ InlineHook& InlineHook::operator=(InlineHook&& other) noexcept {
         m_trampoline = std::move(other.m_trampoline);
         m_trampoline_size = other.m_trampoline_size;
         m_original_bytes = std::move(other.m_original_bytes);
+        m_enabled = other.m_enabled;
+        m_type = other.m_type;
 
         other.m_target = nullptr;
         other.m_destination = nullptr;
         other.m_trampoline_size = 0;
+        other.m_enabled = false;
+        other.m_type = Type::Unset;
     }
 
     return *this;
@@ -716,26 +743,8 @@ std::expected<void, InlineHook::Error> InlineHook::e9_hook(const std::shared_ptr
     }
 #endif
 
-    std::optional<Error> error;
-
-    // jmp from original to trampoline.
-    execute_while_frozen(
-        [this, &trampoline_epilogue, &error] {
-            if (auto result = emit_jmp_e9(m_target,
-                    reinterpret_cast<uint8_t*>(&trampoline_epilogue->jmp_to_destination), m_original_bytes.size());
-                !result) {
-                error = result.error();
-            }
-        },
-        [this](auto, auto, auto ctx) {
-            for (size_t i = 0; i < m_original_bytes.size(); ++i) {
-                fix_ip(ctx, m_target + i, m_trampoline.data() + i);
-            }
-        });
-
-    if (error) {
-        return std::unexpected{*error};
-    }
+    // The jmp from original to trampoline is written by enable().
+    m_type = Type::E9;
 
     return {};
 }
@@ -784,15 +793,44 @@ std::expected<void, InlineHook::Error> InlineHook::ff_hook(const std::shared_ptr
         return std::unexpected{result.error()};
     }
 
+    // The jmp from original to trampoline is written by enable().
+    m_type = Type::FF;
+
+    return {};
+}
+#endif
+
+std::expected<void, InlineHook::Error> InlineHook::enable() {
+    std::scoped_lock lock{m_mutex};
+
+    if (m_enabled || !m_trampoline) {
+        return {};
+    }
+
     std::optional<Error> error;
 
     // jmp from original to trampoline.
     execute_while_frozen(
         [this, &error] {
-            if (auto result = emit_jmp_ff(m_target, m_destination, m_target + sizeof(JmpFF), m_original_bytes.size());
-                !result) {
-                error = result.error();
+            if (m_type == Type::E9) {
+                auto trampoline_epilogue = reinterpret_cast<TrampolineEpilogueE9*>(
+                    m_trampoline.address() + m_trampoline_size - sizeof(TrampolineEpilogueE9));
+
+                if (auto result = emit_jmp_e9(m_target,
+                        reinterpret_cast<uint8_t*>(&trampoline_epilogue->jmp_to_destination), m_original_bytes.size());
+                    !result) {
+                    error = result.error();
+                }
+            }
+#if SAFETYHOOK_ARCH_X86_64
+            else if (m_type == Type::FF) {
+                if (auto result =
+                        emit_jmp_ff(m_target, m_destination, m_target + sizeof(JmpFF), m_original_bytes.size());
+                    !result) {
+                    error = result.error();
+                }
             }
+#endif
         },
         [this](auto, auto, auto ctx) {
             for (size_t i = 0; i < m_original_bytes.size(); ++i) {
@@ -804,21 +842,26 @@ std::expected<void, InlineHook::Error> InlineHook::ff_hook(const std::shared_ptr
         return std::unexpected{*error};
     }
 
+    m_enabled = true;
+
     return {};
 }
-#endif
 
-void InlineHook::destroy() {
+std::expected<void, InlineHook::Error> InlineHook::disable() {
     std::scoped_lock lock{m_mutex};
 
-    if (!m_trampoline) {
-        return;
+    if (!m_enabled) {
+        return {};
     }
 
+    std::optional<Error> error;
+
     execute_while_frozen(
-        [this] {
+        [this, &error] {
             if (auto um = unprotect(m_target, m_original_bytes.size())) {
                 std::copy(m_original_bytes.begin(), m_original_bytes.end(), m_target);
+            } else {
+                error = Error::failed_to_unprotect(m_target);
             }
         },
         [this](auto, auto, auto ctx) {
@@ -827,7 +870,26 @@ void InlineHook::destroy() {
             }
         });
 
+    if (error) {
+        return std::unexpected{*error};
+    }
+
+    m_enabled = false;
+
+    return {};
+}
+
+void InlineHook::destroy() {
+    std::scoped_lock lock{m_mutex};
+
+    if (!m_trampoline) {
+        return;
+    }
+
+    static_cast<void>(disable());
+
     m_trampoline.free();
+    m_enabled = false;
 }
 } // namespace safetyhook
 
@@ -907,9 +969,14 @@ std::expected<MidHook, MidHook::Error> MidHook::create(void* target, MidHookFn d
 
 std::expected<MidHook, MidHook::Error> MidHook::create(
     const std::shared_ptr<Allocator>& allocator, void* target, MidHookFn destination) {
+    return create(allocator, target, destination, Default);
+}
+
+std::expected<MidHook, MidHook::Error> MidHook::create(
+    const std::shared_ptr<Allocator>& allocator, void* target, MidHookFn destination, Flags flags) {
     MidHook hook{};
 
-    if (const auto setup_result = hook.setup(allocator, reinterpret_cast<uint8_t*>(target), destination);
+    if (const auto setup_result = hook.setup(allocator, reinterpret_cast<uint8_t*>(target), destination, flags);
         !setup_result) {
         return std::unexpected{setup_result.error()};
     }
@@ -939,8 +1006,24 @@ void MidHook::reset() {
     *this = {};
 }
 
+std::expected<void, MidHook::Error> MidHook::enable() {
+    if (auto enable_result = m_hook.enable(); !enable_result) {
+        return std::unexpected{Error::bad_inline_hook(enable_result.error())};
+    }
+
+    return {};
+}
+
+std::expected<void, MidHook::Error> MidHook::disable() {
+    if (auto disable_result = m_hook.disable(); !disable_result) {
+        return std::unexpected{Error::bad_inline_hook(disable_result.error())};
+    }
+
+    return {};
+}
+
 std::expected<void, MidHook::Error> MidHook::setup(
-    const std::shared_ptr<Allocator>& allocator, uint8_t* target, MidHookFn destination_fn) {
+    const std::shared_ptr<Allocator>& allocator, uint8_t* target, MidHookFn destination_fn, Flags flags) {
     m_target = target;
     m_destination = destination_fn;
 
@@ -964,7 +1047,8 @@ std::expected<void, MidHook::Error> MidHook::setup(
     store(m_stub.data() + 0x59, m_stub.data() + m_stub.size() - 8);
 #endif
 
-    auto hook_result = InlineHook::create(allocator, m_target, m_stub.data());
+    // Created disabled so the stub knows its trampoline before the target can jump into it.
+    auto hook_result = InlineHook::create(allocator, m_target, m_stub.data(), InlineHook::StartDisabled);
 
     if (!hook_result) {
         m_stub.free();
@@ -979,6 +1063,12 @@ std::expected<void, MidHook::Error> MidHook::setup(
     store(m_stub.data() + sizeof(asm_data) - 4, m_hook.trampoline().data());
 #endif
 
+    if (!(flags & StartDisabled)) {
+        if (auto enable_result = enable(); !enable_result) {
+            return std::unexpected{enable_result.error()};
+        }
+    }
+
     return {};
 }
 } // namespace safetyhook
@@ -1345,104 +1435,156 @@ SystemInfo system_info() {
     return info;
 }
 
-void execute_while_frozen(
-    const std::function<void()>& run_fn, const std::function<void(ThreadId, ThreadHandle, ThreadContext)>& visit_fn) {
-    // Freeze all threads.
-    int num_threads_frozen;
-    auto first_run = true;
-
-    do {
-        num_threads_frozen = 0;
-        HANDLE thread{};
+namespace {
+struct FrozenThread {
+    HANDLE handle;
+    DWORD id;
+    CONTEXT ctx;
+    bool has_ctx;
+};
 
-        while (true) {
-            HANDLE next_thread{};
-            const auto status = NtGetNextThread(GetCurrentProcess(), thread,
-                THREAD_QUERY_LIMITED_INFORMATION | THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, 0,
-                0, &next_thread);
+// Threads frozen by the outermost execute_while_frozen on this thread, reused by nested calls.
+thread_local std::vector<FrozenThread>* t_frozen_threads{};
+} // namespace
 
-            if (thread != nullptr) {
-                CloseHandle(thread);
+void execute_while_frozen(
+    const std::function<void()>& run_fn, const std::function<void(ThreadId, ThreadHandle, ThreadContext)>& visit_fn) {
+    // Already frozen by an outer call, just visit the threads it froze.
+    if (t_frozen_threads != nullptr) {
+        for (auto& frozen : *t_frozen_threads) {
+            if (visit_fn && frozen.has_ctx) {
+                visit_fn(static_cast<ThreadId>(frozen.id), static_cast<ThreadHandle>(frozen.handle),
+                    static_cast<ThreadContext>(&frozen.ctx));
+                SetThreadContext(frozen.handle, &frozen.ctx);
             }
+        }
 
-            if (!NT_SUCCESS(status)) {
-                break;
-            }
+        if (run_fn) {
+            run_fn();
+        }
 
-            thread = next_thread;
+        return;
+    }
 
-            const auto thread_id = GetThreadId(thread);
+    // Adding to the list while other threads are suspended could need the heap lock one of them holds, so room
+    // is reserved before anything is frozen. If more threads turn up than there is room for, everything is
+    // resumed and the freeze starts over with twice the room.
+    std::vector<FrozenThread> frozen_threads;
+    frozen_threads.reserve(64);
 
-            if (thread_id == 0 || thread_id == GetCurrentThreadId()) {
-                continue;
+    // Resumes whatever is frozen on every way out, including an exception from visit_fn or run_fn.
+    struct Resume {
+        std::vector<FrozenThread>& threads;
+
+        void all() {
+            for (const auto& frozen : threads) {
+                ResumeThread(frozen.handle);
+                CloseHandle(frozen.handle);
             }
+            threads.clear();
+        }
 
-            const auto suspend_count = SuspendThread(thread);
+        ~Resume() {
+            t_frozen_threads = nullptr;
+            all();
+        }
+    } resume{frozen_threads};
 
-            if (suspend_count == static_cast<DWORD>(-1)) {
-                continue;
-            }
+    // Freeze all threads.
+    auto out_of_room = false;
 
-            // Check if the thread was already frozen. Only resume if the thread was already frozen, and it wasn't the
-            // first run of this freeze loop to account for threads that may have already been frozen for other reasons.
-            if (suspend_count != 0 && !first_run) {
-                ResumeThread(thread);
-                continue;
+    do {
+        out_of_room = false;
+        int num_threads_frozen;
+        auto first_run = true;
+
+        do {
+            num_threads_frozen = 0;
+            HANDLE thread{};
+            auto keep_thread = false;
+
+            while (true) {
+                HANDLE next_thread{};
+                const auto status = NtGetNextThread(GetCurrentProcess(), thread,
+                    THREAD_QUERY_LIMITED_INFORMATION | THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT,
+                    0, 0, &next_thread);
+
+                // Handles of threads we froze stay open until they are resumed.
+                if (thread != nullptr && !keep_thread) {
+                    CloseHandle(thread);
+                }
+
+                if (!NT_SUCCESS(status)) {
+                    break;
+                }
+
+                thread = next_thread;
+                keep_thread = false;
+
+                const auto thread_id = GetThreadId(thread);
+
+                if (thread_id == 0 || thread_id == GetCurrentThreadId()) {
+                    continue;
+                }
+
+                const auto suspend_count = SuspendThread(thread);
+
+                if (suspend_count == static_cast<DWORD>(-1)) {
+                    continue;
+                }
+
+                // Check if the thread was already frozen. Only resume if the thread was already frozen, and it wasn't
+                // the first run of this freeze loop to account for threads that may have already been frozen for
+                // other reasons.
+                if (suspend_count != 0 && !first_run) {
+                    ResumeThread(thread);
+                    continue;
+                }
+
+                if (frozen_threads.size() == frozen_threads.capacity()) {
+                    ResumeThread(thread);
+                    CloseHandle(thread);
+                    out_of_room = true;
+                    break;
+                }
+
+                keep_thread = true;
+                auto& frozen = frozen_threads.emplace_back(FrozenThread{thread, thread_id, {}, false});
+
+                frozen.ctx.ContextFlags = CONTEXT_FULL;
+                frozen.has_ctx = GetThreadContext(thread, &frozen.ctx) != FALSE;
+
+                ++num_threads_frozen;
             }
 
-            CONTEXT thread_ctx{};
-
-            thread_ctx.ContextFlags = CONTEXT_FULL;
+            first_run = false;
+        } while (num_threads_frozen != 0 && !out_of_room);
 
-            if (GetThreadContext(thread, &thread_ctx) == FALSE) {
-                continue;
-            }
+        // Nothing is frozen while the list grows.
+        if (out_of_room) {
+            const auto room = frozen_threads.capacity() * 2;
+            resume.all();
+            frozen_threads.reserve(room);
+        }
+    } while (out_of_room);
 
+    // Visited once everything is frozen, so a restarted freeze never visits a thread twice.
+    for (auto& frozen : frozen_threads) {
+        if (frozen.has_ctx) {
             if (visit_fn) {
-                visit_fn(static_cast<ThreadId>(thread_id), static_cast<ThreadHandle>(thread),
-                    static_cast<ThreadContext>(&thread_ctx));
+                visit_fn(static_cast<ThreadId>(frozen.id), static_cast<ThreadHandle>(frozen.handle),
+                    static_cast<ThreadContext>(&frozen.ctx));
             }
 
-            SetThreadContext(thread, &thread_ctx);
-
-            ++num_threads_frozen;
+            SetThreadContext(frozen.handle, &frozen.ctx);
         }
-
-        first_run = false;
-    } while (num_threads_frozen != 0);
+    }
 
     // Run the function.
     if (run_fn) {
+        t_frozen_threads = &frozen_threads;
         run_fn();
     }
-
-    // Resume all threads.
-    HANDLE thread{};
-
-    while (true) {
-        HANDLE next_thread{};
-        const auto status = NtGetNextThread(GetCurrentProcess(), thread,
-            THREAD_QUERY_LIMITED_INFORMATION | THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, 0, 0,
-            &next_thread);
-
-        if (thread != nullptr) {
-            CloseHandle(thread);
-        }
-
-        if (!NT_SUCCESS(status)) {
-            break;
-        }
-
-        thread = next_thread;
-
-        const auto thread_id = GetThreadId(thread);
-
-        if (thread_id == 0 || thread_id == GetCurrentThreadId()) {
-            continue;
-        }
-
-        ResumeThread(thread);
-    }
 }
 
 void fix_ip(ThreadContext thread_ctx, uint8_t* old_ip, uint8_t* new_ip) {
@@ -125,18 +125,27 @@ public:
     /// @return The new Allocator.
     [[nodiscard]] static std::shared_ptr<Allocator> create();
 
-    Allocator(const Allocator&) = delete;
-    Allocator(Allocator&&) noexcept = delete;
-    Allocator& operator=(const Allocator&) = delete;
-    Allocator& operator=(Allocator&&) noexcept = delete;
-    ~Allocator() = default;
-
     /// @brief The error type returned by the allocate functions.
     enum class Error : uint8_t {
         BAD_VIRTUAL_ALLOC,  ///< VirtualAlloc failed.
         NO_MEMORY_IN_RANGE, ///< No memory in range.
     };
 
+    /// @brief Creates a new Allocator in arena mode. One region is reserved near the given address up front and
+    /// allocations are carved out of it back to back, each aligned to the given alignment.
+    /// @param near_address The address the region should be near, e.g. the base of the module being hooked.
+    /// @param size The size of the region to reserve. Allocations that don't fit fall back to new regions.
+    /// @param alignment The alignment of every allocation, must be a power of two. Defaults to a cache line.
+    /// @return The new Allocator or an Allocator::Error if the region could not be reserved.
+    [[nodiscard]] static std::expected<std::shared_ptr<Allocator>, Error> create_arena(
+        uint8_t* near_address, size_t size, size_t alignment = 64);
+
+    Allocator(const Allocator&) = delete;
+    Allocator(Allocator&&) noexcept = delete;
+    Allocator& operator=(const Allocator&) = delete;
+    Allocator& operator=(Allocator&&) noexcept = delete;
+    ~Allocator() = default;
+
     /// @brief Allocates memory.
     /// @param size The size of the allocation.
     /// @return The Allocation or an Allocator::Error if the allocation failed.
@@ -172,6 +181,7 @@ private:
 
     std::vector<std::unique_ptr<Memory>> m_memory{};
     std::mutex m_mutex{};
+    size_t m_alignment{1};
 
     Allocator() = default;
 
@@ -285,6 +295,7 @@ private:
 #ifndef SAFETYHOOK_USE_CXXMODULES
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <type_traits>
 #else
@@ -334,6 +345,28 @@ template <typename T> constexpr T align_down(T address, size_t align) {
     const auto aligned_address = unaligned_address & ~(align - 1);
     return (T)aligned_address;
 }
+
+using ThreadId = uint32_t;
+using ThreadHandle = void*;
+using ThreadContext = void*;
+
+/// @brief Executes a function while all other threads are frozen. Also allows for visiting each frozen thread and
+/// modifying it's context.
+/// @param run_fn The function to run while all other threads are frozen.
+/// @param visit_fn The function that will be called for each frozen thread.
+/// @note The visit function will be called in the order that the threads were frozen.
+/// @note The visit function will be called before the run function.
+/// @note Keep the logic inside run_fn and visit_fn as simple as possible to avoid deadlocks.
+/// @note Calls are re-entrant. A call made from inside run_fn reuses the threads frozen by the outer call instead of
+/// freezing them again, so several hooks can be enabled or disabled under a single freeze.
+void execute_while_frozen(const std::function<void()>& run_fn,
+    const std::function<void(ThreadId, ThreadHandle, ThreadContext)>& visit_fn = {});
+
+/// @brief Will modify the context of a thread's IP to point to a new address if its IP is at the old address.
+/// @param ctx The thread context to modify.
+/// @param old_ip The old IP address.
+/// @param new_ip The new IP address.
+void fix_ip(ThreadContext ctx, uint8_t* old_ip, uint8_t* new_ip);
 } // namespace safetyhook
 
 namespace safetyhook {
@@ -405,6 +438,12 @@ public:
         [[nodiscard]] static Error not_enough_space(uint8_t* ip) { return {.type = NOT_ENOUGH_SPACE, .ip = ip}; }
     };
 
+    /// @brief Flags for InlineHook.
+    enum Flags : int {
+        Default = 0,            ///< Default flags.
+        StartDisabled = 1 << 0, ///< Start the hook disabled.
+    };
+
     /// @brief Create an inline hook.
     /// @param target The address of the function to hook.
     /// @param destination The destination address.
@@ -432,6 +471,16 @@ public:
     [[nodiscard]] static std::expected<InlineHook, Error> create(
         const std::shared_ptr<Allocator>& allocator, void* target, void* destination);
 
+    /// @brief Create an inline hook with a given Allocator and Flags.
+    /// @param allocator The allocator to use.
+    /// @param target The address of the function to hook.
+    /// @param destination The destination address.
+    /// @param flags The flags to use.
+    /// @return The InlineHook or an InlineHook::Error if an error occurred.
+    /// @note With StartDisabled the trampoline is built but the target is left untouched until enable() is called.
+    [[nodiscard]] static std::expected<InlineHook, Error> create(
+        const std::shared_ptr<Allocator>& allocator, void* target, void* destination, Flags flags);
+
     /// @brief Create an inline hook with a given Allocator.
     /// @param allocator The allocator to use.
     /// @param target The address of the function to hook.
@@ -488,6 +537,20 @@ public:
     /// @return A vector of the original bytes of the target function.
     [[nodiscard]] const auto& original_bytes() const { return m_original_bytes; }
 
+    /// @brief Enable the hook by writing the jump to the target.
+    /// @return Nothing or an InlineHook::Error if an error occurred.
+    /// @note Does nothing if the hook is already enabled.
+    [[nodiscard]] std::expected<void, Error> enable();
+
+    /// @brief Disable the hook by restoring the original bytes. The trampoline is kept so it can be enabled again.
+    /// @return Nothing or an InlineHook::Error if an error occurred.
+    /// @note Does nothing if the hook is already disabled.
+    [[nodiscard]] std::expected<void, Error> disable();
+
+    /// @brief Tests if the hook is enabled.
+    /// @return True if the hook is enabled, false otherwise.
+    [[nodiscard]] bool enabled() const { return m_enabled; }
+
     /// @brief Calls the original function.
     /// @tparam RetT The return type of the function.
     /// @tparam ...Args The argument types of the function.
@@ -612,6 +675,9 @@ private:
     std::vector<uint8_t> m_original_bytes{};
     uintptr_t m_trampoline_size{};
     std::recursive_mutex m_mutex{};
+    bool m_enabled{};
+
+    enum class Type { Unset, E9, FF } m_type{Type::Unset};
 
     std::expected<void, Error> setup(
         const std::shared_ptr<Allocator>& allocator, uint8_t* target, uint8_t* destination);
@@ -749,6 +815,12 @@ public:
         }
     };
 
+    /// @brief Flags for MidHook.
+    enum Flags : int {
+        Default = 0,            ///< Default flags.
+        StartDisabled = 1 << 0, ///< Start the hook disabled.
+    };
+
     /// @brief Creates a new MidHook object.
     /// @param target The address of the function to hook.
     /// @param destination_fn The destination function.
@@ -776,6 +848,16 @@ public:
     [[nodiscard]] static std::expected<MidHook, Error> create(
         const std::shared_ptr<Allocator>& allocator, void* target, MidHookFn destination_fn);
 
+    /// @brief Creates a new MidHook object with a given Allocator and Flags.
+    /// @param allocator The Allocator to use.
+    /// @param target The address of the function to hook.
+    /// @param destination_fn The destination function.
+    /// @param flags The flags to use.
+    /// @return The MidHook object or a MidHook::Error if an error occurred.
+    /// @note With StartDisabled the stub and trampoline are built but the target is left untouched until enable().
+    [[nodiscard]] static std::expected<MidHook, Error> create(
+        const std::shared_ptr<Allocator>& allocator, void* target, MidHookFn destination_fn, Flags flags);
+
     /// @brief Creates a new MidHook object with a given Allocator.
     /// @tparam T The type of the function to hook.
     /// @param allocator The Allocator to use.
@@ -820,6 +902,18 @@ public:
     /// @return true if the hook is valid, false otherwise.
     explicit operator bool() const { return static_cast<bool>(m_stub); }
 
+    /// @brief Enable the hook.
+    /// @return Nothing or a MidHook::Error if an error occurred.
+    [[nodiscard]] std::expected<void, Error> enable();
+
+    /// @brief Disable the hook. The stub is kept so it can be enabled again.
+    /// @return Nothing or a MidHook::Error if an error occurred.
+    [[nodiscard]] std::expected<void, Error> disable();
+
+    /// @brief Tests if the hook is enabled.
+    /// @return True if the hook is enabled, false otherwise.
+    [[nodiscard]] bool enabled() const { return m_hook.enabled(); }
+
 private:
     InlineHook m_hook{};
     uint8_t* m_target{};
@@ -827,7 +921,7 @@ private:
     MidHookFn m_destination{};
 
     std::expected<void, Error> setup(
-        const std::shared_ptr<Allocator>& allocator, uint8_t* target, MidHookFn destination);
+        const std::shared_ptr<Allocator>& allocator, uint8_t* target, MidHookFn destination, Flags flags);
 };
 } // namespace safetyhook
 
@@ -1022,15 +1116,17 @@ namespace safetyhook {
 /// @brief Easy to use API for creating a MidHook.
 /// @param target the address of the function to hook.
 /// @param destination The destination function.
+/// @param flags The flags to use.
 /// @return The MidHook object.
-[[nodiscard]] MidHook create_mid(void* target, MidHookFn destination);
+[[nodiscard]] MidHook create_mid(void* target, MidHookFn destination, MidHook::Flags flags = MidHook::Default);
 
 /// @brief Easy to use API for creating a MidHook.
 /// @param target the address of the function to hook.
 /// @param destination The destination function.
+/// @param flags The flags to use.
 /// @return The MidHook object.
-[[nodiscard]] MidHook create_mid(FnPtr auto target, MidHookFn destination) {
-    return create_mid(reinterpret_cast<void*>(target), destination);
+[[nodiscard]] MidHook create_mid(FnPtr auto target, MidHookFn destination, MidHook::Flags flags = MidHook::Default) {
+    return create_mid(reinterpret_cast<void*>(target), destination, flags);
 }
 
 /// @brief Easy to use API for creating a VmtHook.
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "scanner.hpp"
+
+namespace Scanner
+{
+    // FNV-1a over the section name and the value/mask bytes, so editing a signature changes its key.
+    inline std::uint64_t Hash(const Pattern& pattern, const std::string& section = {})
+    {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        auto add = [&hash](std::uint8_t byte) {
+            hash ^= byte;
+            hash *= 0x100000001B3ull;
+        };
+
+        for (auto c : section)
+            add(static_cast<std::uint8_t>(c));
+        add(0);
+        for (std::size_t i = 0; i < pattern.Size(); ++i) {
+            add(pattern.value[i]);
+            add(pattern.mask[i]);
+        }
+        return hash;
+    }
+
+    // Signature RVAs from previous launches. Entries are keyed on the module's timestamp and
+    // SizeOfImage as well as the signature, so offsets are never reused across game builds.
+    // Entries for other builds are kept when saving so switching between versions stays warm.
+    class Cache
+    {
+    public:
+        Cache(std::uint32_t timestamp, std::uint32_t sizeOfImage) : timestamp(timestamp), sizeOfImage(sizeOfImage) {}
+
+        // One "timestamp sizeOfImage hash rva" line per entry, in hex. Malformed lines are ignored.
+        bool Load(const std::filesystem::path& path)
+        {
+            std::ifstream file(path);
+            if (!file)
+                return false;
+
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.empty() || line[0] == '#')
+                    continue;
+
+                std::istringstream fields(line);
+                std::uint32_t entryTimestamp, entrySize, rva;
+                std::uint64_t hash;
+                if (fields >> std::hex >> entryTimestamp >> entrySize >> hash >> rva)
+                    entries[{ entryTimestamp, entrySize, hash }] = rva;
+            }
+            return true;
+        }
+
+        // Written to a temporary file first so a crash mid-write can't leave a truncated cache.
+        bool Save(const std::filesystem::path& path)
+        {
+            auto temporary = path;
+            temporary += ".tmp";
+            {
+                std::ofstream file(temporary, std::ios::trunc);
+                if (!file)
+                    return false;
+
+                file << "# Signature cache, safe to delete\n" << std::hex;
+                for (const auto& [key, rva] : entries)
+                    file << std::get<0>(key) << ' ' << std::get<1>(key) << ' ' << std::get<2>(key) << ' ' << rva << '\n';
+                if (!file.flush())
+                    return false;
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporary, path, error);
+            if (error)
+                return false;
+            dirty = false;
+            return true;
+        }
+
+        std::optional<std::uint32_t> Find(std::uint64_t hash) const
+        {
+            auto it = entries.find({ timestamp, sizeOfImage, hash });
+            if (it == entries.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        void Store(std::uint64_t hash, std::uint32_t rva)
+        {
+            auto [it, inserted] = entries.try_emplace({ timestamp, sizeOfImage, hash }, rva);
+            if (inserted || it->second != rva) {
+                it->second = rva;
+                dirty = true;
+            }
+        }
+
+        void Erase(std::uint64_t hash)
+        {
+            if (entries.erase({ timestamp, sizeOfImage, hash }))
+                dirty = true;
+        }
+
+        bool Dirty() const { return dirty; }
+
+    private:
+        using Key = std::tuple<std::uint32_t, std::uint32_t, std::uint64_t>;
+
+        std::uint32_t timestamp;
+        std::uint32_t sizeOfImage;
+        std::map<Key, std::uint32_t> entries;
+        bool dirty = false;
+    };
+
+    // Signatures with a cached RVA are only verified in place instead of scanned for. Stale entries are
+    // dropped and fresh results stored. Returns how many came from the cache.
+    inline std::size_t ScanCached(const std::uint8_t* base, const std::vector<Region>& regions, Batch& batch, Cache& cache, unsigned threads = 1)
+    {
+        std::size_t cached = 0;
+        for (const auto& entry : batch.Entries()) {
+            auto rva = cache.Find(Hash(entry.pattern, entry.section));
+            if (rva && batch.Seed(entry.name, base + *rva, regions))
+                ++cached;
+        }
+
+        batch.Scan(regions, threads);
+
+        for (const auto& entry : batch.Entries()) {
+            auto hash = Hash(entry.pattern, entry.section);
+            if (entry.result)
+                cache.Store(hash, static_cast<std::uint32_t>(entry.result - base));
+            else
+                cache.Erase(hash);
+        }
+        return cached;
+    }
+}
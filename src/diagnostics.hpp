@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// Optional per-hook instrumentation. Each probe counts invocations per thread and keeps a
+// log2 histogram of how many TSC ticks the hook body took. Only compiled in when
+// DDDAFIX_DIAGNOSTICS is defined, otherwise DIAGNOSTICS_PROBE expands to nothing.
+namespace Diagnostics
+{
+    constexpr std::size_t MaxThreads = 16;
+    constexpr std::size_t Buckets = 32;
+
+    inline std::atomic<bool> enabled{ false };
+
+    inline std::uint64_t Ticks()
+    {
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    inline std::size_t Bucket(std::uint64_t ticks)
+    {
+        std::size_t bucket = 0;
+        while (ticks > 1 && bucket + 1 < Buckets) {
+            ticks >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // Threads are numbered in the order they first hit any probe. Threads past MaxThreads share the
+    // last slot, which is the only one updated with atomic read-modify-writes.
+    inline std::size_t ThreadSlot()
+    {
+        static std::atomic<std::size_t> next{ 0 };
+        thread_local std::size_t slot = (std::min)(next.fetch_add(1, std::memory_order_relaxed), MaxThreads - 1);
+        return slot;
+    }
+
+    class Probe;
+
+    inline std::mutex& RegistryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    inline std::vector<Probe*>& Registry()
+    {
+        static std::vector<Probe*> probes;
+        return probes;
+    }
+
+    class Probe
+    {
+    public:
+        explicit Probe(const char* name) : name(name)
+        {
+            std::lock_guard lock(RegistryMutex());
+            Registry().push_back(this);
+        }
+
+        void Record(std::uint64_t ticks)
+        {
+            auto index = ThreadSlot();
+            auto& slot = slots[index];
+            if (index == MaxThreads - 1) {
+                slot.count.fetch_add(1, std::memory_order_relaxed);
+                slot.histogram[Bucket(ticks)].fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // Single writer per slot, so a plain load/store pair is enough
+            slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            auto& bucket = slot.histogram[Bucket(ticks)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // One line per probe: total calls, calls since the previous summary, calls per thread and
+        // the histogram buckets holding the median and 99th percentile.
+        std::string Summary()
+        {
+            std::uint64_t total = 0;
+            std::array<std::uint64_t, Buckets> histogram{};
+            std::string threads;
+
+            for (std::size_t i = 0; i < MaxThreads; ++i) {
+                auto count = slots[i].count.load(std::memory_order_relaxed);
+                if (!count)
+                    continue;
+                total += count;
+                for (std::size_t b = 0; b < Buckets; ++b)
+                    histogram[b] += slots[i].histogram[b].load(std::memory_order_relaxed);
+
+                char thread[48];
+                std::snprintf(thread, sizeof(thread), " T%zu=%llu", i, static_cast<unsigned long long>(count));
+                threads += thread;
+            }
+
+            auto percentile = [&](double fraction) {
+                std::uint64_t seen = 0;
+                for (std::size_t b = 0; b < Buckets; ++b) {
+                    seen += histogram[b];
+                    if (total && seen >= fraction * total)
+                        return std::uint64_t(1) << (b + 1);
+                }
+                return std::uint64_t(0);
+            };
+
+            auto sinceLast = total - lastTotal;
+            lastTotal = total;
+
+            char line[256];
+            std::snprintf(line, sizeof(line), "%s: calls %llu (+%llu), p50 < %llu ticks, p99 < %llu ticks,",
+                name, static_cast<unsigned long long>(total), static_cast<unsigned long long>(sinceLast),
+                static_cast<unsigned long long>(percentile(0.5)), static_cast<unsigned long long>(percentile(0.99)));
+            return line + threads;
+        }
+
+        const char* Name() const { return name; }
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<std::uint64_t> count{ 0 };
+            std::array<std::atomic<std::uint64_t>, Buckets> histogram{};
+        };
+
+        const char* name;
+        std::array<Slot, MaxThreads> slots{};
+        std::uint64_t lastTotal = 0;
+    };
+
+    class ScopedProbe
+    {
+    public:
+        explicit ScopedProbe(Probe& probe) : probe(enabled.load(std::memory_order_relaxed) ? &probe : nullptr)
+        {
+            if (this->probe)
+                start = Ticks();
+        }
+
+        ~ScopedProbe()
+        {
+            if (probe)
+                probe->Record(Ticks() - start);
+        }
+
+        ScopedProbe(const ScopedProbe&) = delete;
+        ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+    private:
+        Probe* probe;
+        std::uint64_t start = 0;
+    };
+
+    // Summaries for every probe that has fired at least once.
+    inline std::vector<std::string> Summaries()
+    {
+        std::lock_guard lock(RegistryMutex());
+        std::vector<std::string> lines;
+        for (auto probe : Registry())
+            lines.push_back(probe->Summary());
+        return lines;
+    }
+}
+
+#if defined(DDDAFIX_DIAGNOSTICS)
+#define DIAGNOSTICS_PROBE(name) \
+    static Diagnostics::Probe diagnosticsProbe(name); \
+    Diagnostics::ScopedProbe diagnosticsScope(diagnosticsProbe)
+#else
+#define DIAGNOSTICS_PROBE(name) ((void)0)
+#endif
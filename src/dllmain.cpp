@@ -1,10 +1,21 @@
 #include "stdafx.h"
 #include "helper.hpp"
+#include "hooks.hpp"
+#include "diagnostics.hpp"
+#include "fixes.hpp"
+#include "frametime.hpp"
+#include "layout.hpp"
+#include "limiter.hpp"
+#include "seqlock.hpp"
+#include "signatures.hpp"
 #include <inipp/inipp.h>
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <safetyhook.hpp>
 
+using LeanHook::Reg;
+
 HMODULE baseModule = GetModuleHandle(NULL);
 HMODULE thisModule;
 
@@ -15,6 +26,7 @@ string sFixName = "DDDAFix";
 string sFixVer = "0.9.1";
 string sLogFile = "DDDAFix.log";
 string sConfigFile = "DDDAFix.ini";
+string sCacheFile = "DDDAFix.cache";
 string sExeName;
 filesystem::path sExePath;
 filesystem::path sThisModulePath;
@@ -22,34 +34,52 @@ RECT rcDesktop;
 
 // Aspect Ratio
 float fPi = (float)3.141592653;
-float fNativeAspect = (float)16 / 9;
-float fAspectRatio;
-float fAspectMultiplier;
-float fHUDWidth;
-float fHUDHeight;
-float fDefaultHUDWidth = (float)1920;
-float fDefaultHUDHeight = (float)1080;
-float fHUDWidthOffset;
-float fHUDHeightOffset;
+SeqLock<Layout::LayoutState> ResolutionLayout;
 
 // Ini variables
 int iInjectionDelay;
+int iReadinessTimeout = 10000;
+bool bHotReload = true;
+bool bAsyncLogging = true;
+int iLogQueueSize = 8192;
+string sLogOverflowPolicy = "drop";
+int iLogFlushInterval = 1;
+bool bDiagnostics;
+int iDiagnosticsInterval = 30;
+bool bFrameTimeCapture;
+string sCaptureHotkey = "0x7A";
+int iCaptureHotkey = VK_F11;
+int iFrameTimeReportInterval = 10;
+float fStutterThreshold = 2.0f;
 bool bDisablePauseOnFocusLoss;
 bool bUncapFPS;
+bool bFrameLimiter;
+constexpr float fDefaultFrameLimit = 141.0f;
+float fFrameLimit = fDefaultFrameLimit;
 bool bBorderlessWindowed;
 bool bFixHUD;
 bool bFixFOV;
 
 // Variables
-int iResX = 1920;
-int iResY = 1080;
-float fDefMinimapMulti = 0.0007812500116f;
-int iOrigMinimapWidthOffset = 0;
-int iOrigMinimapHeightOffset = 0;
+Scanner::Batch Signatures;
+Resolve::Image ModuleImage;
+std::array<Resolve::Address<>, std::size(GameSignatures::All)> SignatureTargets;
+HookBatch Hooks;
+ConstantPatch HUDWidthPatch;
+ConstantPatch TitleBackgroundPatch;
+FrameTime::Recorder<> FrameRecorder;
+std::atomic<float> fFrameLimitTarget;
+uintptr_t VariableFPSAddress;
+float fOriginalVariableFPS;
 int iFullscreenMode;
 LPCWSTR sWindowClassName = L"Dragons Dogma: Dark Arisen";
 
 HWND hWnd;
+HANDLE hWindowClosed;
+HANDLE hAspectChanged;
+ULONGLONG iWindowLostTick;
+bool bWindowSeen;
+bool bWindowModeKnown;
 WNDPROC OldWndProc;
 LRESULT __stdcall NewWndProc(HWND window, UINT message_type, WPARAM w_param, LPARAM l_param) {
     if (bDisablePauseOnFocusLoss)
@@ -79,14 +109,43 @@ void Logging()
     sExeName = sExePath.filename().string();
     sExePath = sExePath.remove_filename();
 
+    // Logging options are needed before the logger exists, so read them straight from the ini
+    {
+        std::ifstream iniFile(sThisModulePath.string() + sConfigFile);
+        if (iniFile)
+        {
+            inipp::Ini<char> logIni;
+            logIni.parse(iniFile);
+            inipp::get_value(logIni.sections["Logging"], "Async", bAsyncLogging);
+            inipp::get_value(logIni.sections["Logging"], "QueueSize", iLogQueueSize);
+            inipp::get_value(logIni.sections["Logging"], "OverflowPolicy", sLogOverflowPolicy);
+            inipp::get_value(logIni.sections["Logging"], "FlushInterval", iLogFlushInterval);
+        }
+    }
+
     // spdlog initialisation
     {
         try
         {
-            logger = spdlog::basic_logger_st(sFixName.c_str(), sThisModulePath.string() + sLogFile, true);
-            spdlog::set_default_logger(logger);
+            if (bAsyncLogging)
+            {
+                // Callers only format into the queue, the file is written and flushed on spdlog's worker thread
+                spdlog::init_thread_pool((size_t)(std::max)(iLogQueueSize, 16), 1);
+                auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(sThisModulePath.string() + sLogFile, true);
+                auto overflowPolicy = (sLogOverflowPolicy == "block") ? spdlog::async_overflow_policy::block : spdlog::async_overflow_policy::overrun_oldest;
+                logger = std::make_shared<spdlog::async_logger>(sFixName, fileSink, spdlog::thread_pool(), overflowPolicy);
+                spdlog::set_default_logger(logger);
+
+                spdlog::flush_on(spdlog::level::warn);
+                spdlog::flush_every(std::chrono::seconds((std::max)(iLogFlushInterval, 1)));
+            }
+            else
+            {
+                logger = spdlog::basic_logger_st(sFixName.c_str(), sThisModulePath.string() + sLogFile, true);
+                spdlog::set_default_logger(logger);
 
-            spdlog::flush_on(spdlog::level::debug);
+                spdlog::flush_on(spdlog::level::debug);
+            }
             spdlog::info("----------");
             spdlog::info("{} v{} loaded.", sFixName.c_str(), sFixVer.c_str());
             spdlog::info("----------");
@@ -131,63 +190,207 @@ void ReadConfig()
 
     // Read ini file
     inipp::get_value(ini.sections["DDDAFix Parameters"], "InjectionDelay", iInjectionDelay);
+    inipp::get_value(ini.sections["DDDAFix Parameters"], "ReadinessTimeout", iReadinessTimeout);
+    inipp::get_value(ini.sections["DDDAFix Parameters"], "HotReload", bHotReload);
     inipp::get_value(ini.sections["Raise Framerate Cap"], "Enabled", bUncapFPS);
+    inipp::get_value(ini.sections["Frame Limiter"], "Enabled", bFrameLimiter);
+    inipp::get_value(ini.sections["Frame Limiter"], "Framerate", fFrameLimit);
     inipp::get_value(ini.sections["Disable Pause on Focus Loss"], "Enabled", bDisablePauseOnFocusLoss);
     inipp::get_value(ini.sections["Borderless Windowed Mode"], "Enabled", bBorderlessWindowed);
     inipp::get_value(ini.sections["Fix HUD"], "Enabled", bFixHUD);
     inipp::get_value(ini.sections["Fix FOV"], "Enabled", bFixFOV);
+    inipp::get_value(ini.sections["Frame Time Capture"], "Enabled", bFrameTimeCapture);
+    inipp::get_value(ini.sections["Frame Time Capture"], "Hotkey", sCaptureHotkey);
+    inipp::get_value(ini.sections["Frame Time Capture"], "ReportInterval", iFrameTimeReportInterval);
+    inipp::get_value(ini.sections["Frame Time Capture"], "StutterThreshold", fStutterThreshold);
+    inipp::get_value(ini.sections["Diagnostics"], "Enabled", bDiagnostics);
+    inipp::get_value(ini.sections["Diagnostics"], "DumpInterval", iDiagnosticsInterval);
 
     // Log config parse
     spdlog::info("Config Parse: iInjectionDelay: {}ms", iInjectionDelay);
+    spdlog::info("Config Parse: iReadinessTimeout: {}ms", iReadinessTimeout);
+    spdlog::info("Config Parse: bHotReload: {}", bHotReload);
+    spdlog::info("Config Parse: bAsyncLogging: {}", bAsyncLogging);
+    if (bAsyncLogging)
+    {
+        spdlog::info("Config Parse: iLogQueueSize: {}", iLogQueueSize);
+        spdlog::info("Config Parse: sLogOverflowPolicy: {}", sLogOverflowPolicy);
+        spdlog::info("Config Parse: iLogFlushInterval: {}s", iLogFlushInterval);
+    }
     spdlog::info("Config Parse: bUncapFPS: {}", bUncapFPS);
+    spdlog::info("Config Parse: bFrameLimiter: {}", bFrameLimiter);
+    if (bFrameLimiter)
+    {
+        if (fFrameLimit <= 0)
+        {
+            spdlog::warn("Config Parse: Frame limiter framerate must be above 0, disabling frame limiter.");
+            bFrameLimiter = false;
+        }
+        spdlog::info("Config Parse: fFrameLimit: {}", fFrameLimit);
+    }
     spdlog::info("Config Parse: bDisablePauseOnFocusLoss: {}", bDisablePauseOnFocusLoss);
     spdlog::info("Config Parse: bBorderlessWindowed: {}", bBorderlessWindowed);
     spdlog::info("Config Parse: bFixHUD: {}", bFixHUD);
     spdlog::info("Config Parse: bFixFOV: {}", bFixFOV);
+    spdlog::info("Config Parse: bFrameTimeCapture: {}", bFrameTimeCapture);
+    if (bFrameTimeCapture)
+    {
+        try
+        {
+            iCaptureHotkey = std::stoi(sCaptureHotkey, nullptr, 0);
+        }
+        catch (const std::exception&)
+        {
+            spdlog::warn("Config Parse: Invalid frame time capture hotkey \"{}\", using F11.", sCaptureHotkey);
+            iCaptureHotkey = VK_F11;
+        }
+        spdlog::info("Config Parse: iCaptureHotkey: {:#x}", iCaptureHotkey);
+        spdlog::info("Config Parse: iFrameTimeReportInterval: {}s", iFrameTimeReportInterval);
+        spdlog::info("Config Parse: fStutterThreshold: {}", fStutterThreshold);
+    }
+    spdlog::info("Config Parse: bDiagnostics: {}", bDiagnostics);
+    if (bDiagnostics)
+    {
+        spdlog::info("Config Parse: iDiagnosticsInterval: {}s", iDiagnosticsInterval);
+    }
+    Diagnostics::enabled = bDiagnostics;
+
+    spdlog::info("----------");
+}
+
+void ScanSignatures()
+{
+    // Register every signature up front so the module image is only walked once. Features the ini
+    // turns off are still located so a config reload can turn them on.
+    for (const auto& signature : GameSignatures::All)
+    {
+        Signatures.Add(signature.name, signature.signature);
+    }
+
+    // Cached offsets are only trusted for the exact build they were found in
+    Scanner::Cache cache(Memory::ModuleTimestamp(baseModule), Memory::ModuleSize(baseModule));
+    auto cachePath = sThisModulePath / sCacheFile;
+    cache.Load(cachePath);
+
+    // Wait for the game's code to be mapped and unpacked rather than sleeping for a fixed time
+    const auto& entries = Signatures.Entries();
+    auto probe = std::find_if(entries.begin(), entries.end(), [](const Scanner::Batch::Entry& entry) { return entry.name == "CurrentResolution"; });
+    auto readyStart = std::chrono::steady_clock::now();
+    bool bReady = Memory::WaitForCode(baseModule, probe->pattern, cache, std::chrono::milliseconds((std::max)(iReadinessTimeout, 0)));
+    auto readyTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - readyStart);
+    if (bReady)
+    {
+        spdlog::info("Readiness: Game code ready after {}ms.", readyTime.count());
+    }
+    else
+    {
+        spdlog::warn("Readiness: Timed out after {}ms waiting for game code, scanning anyway.", readyTime.count());
+    }
+
+    if (iInjectionDelay > 0)
+    {
+        Sleep(iInjectionDelay);
+    }
+
+    auto scanThreads = Memory::ScanThreads();
+    auto scanStart = std::chrono::steady_clock::now();
+    auto cached = Memory::PatternScan(baseModule, Signatures, cache, scanThreads);
+    auto scanTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - scanStart);
+
+    spdlog::info("Signatures: Resolved {}/{} signatures ({} from cache) in {}ms on {} threads.", Signatures.Found(), Signatures.Size(), cached, scanTime.count(), scanThreads);
+
+    // Follow each match to its target once, so later code only ever sees addresses inside the module
+    ModuleImage = Memory::ModuleImage(baseModule);
+    for (size_t i = 0; i < std::size(GameSignatures::All); ++i)
+    {
+        const auto& signature = GameSignatures::All[i];
+        auto match = Signatures.Get(signature.name);
+        SignatureTargets[i] = Resolve::Follow(signature.target, match, ModuleImage);
+        if (match && !SignatureTargets[i])
+        {
+            spdlog::error("Signatures: {} was found but its target lies outside the module.", signature.name);
+        }
+    }
 
+    if (cache.Dirty() && !cache.Save(cachePath))
+    {
+        spdlog::error("Signatures: Failed to write cache file {}", cachePath.string());
+    }
     spdlog::info("----------");
 }
 
+// Resolved target of a signature, empty if the scan or the chain failed
+template<typename T = uint8_t>
+Resolve::Address<T> Target(std::string_view name)
+{
+    for (size_t i = 0; i < std::size(GameSignatures::All); ++i)
+    {
+        if (name == GameSignatures::All[i].name && ModuleImage.Contains(SignatureTargets[i].get(), sizeof(T)))
+        {
+            return SignatureTargets[i].template As<T>();
+        }
+    }
+    return {};
+}
+
+void HookArena()
+{
+    // ~80 mid hooks at one 192 byte stub and one 64 byte trampoline each fit well inside a single 64KB region
+    if (Hooks.UseArena(baseModule, 64 * 1024))
+    {
+        spdlog::info("Hooks: Reserved a shared 64KB region near the module for hook stubs.");
+    }
+    else
+    {
+        spdlog::warn("Hooks: Failed to reserve a shared region for hook stubs, allocating them separately.");
+    }
+}
+
+// Values the constant patches load, re-applied whenever the resolution changes
+void UpdateConstantPatches(const Layout::LayoutState& layout)
+{
+    HUDWidthPatch.Set(layout.aspect == Layout::Aspect::Wider ? (float)layout.iResY : HUDWidthPatch.Original());
+    TitleBackgroundPatch.Set(layout.aspect != Layout::Aspect::Native ? 1.0f : TitleBackgroundPatch.Original());
+}
+
 void GetResolution()
 {
     // Get current resolution
-    uint8_t* CurrentResolutionScanResult = Memory::PatternScan(baseModule, "83 ?? 08 8B ?? 89 ?? 8B ?? ?? ?? ?? ?? 8B ?? 89 ?? ?? E8 ?? ?? ?? ?? 8B ?? 89 ?? ?? ?? 3B ?? 75 ??") + 0xD;
+    uint8_t* CurrentResolutionScanResult = Target("CurrentResolution").get();
     if (CurrentResolutionScanResult)
     {
         spdlog::info("Current Resolution: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)CurrentResolutionScanResult - (uintptr_t)baseModule);
 
         static SafetyHookMid CurrentResolutionMidHook{};
-        CurrentResolutionMidHook = safetyhook::create_mid(CurrentResolutionScanResult,
+        Hooks.Create(CurrentResolutionMidHook, CurrentResolutionScanResult,
             [](SafetyHookContext& ctx)
             {
-                iResX = (int)ctx.ecx;
-                iResY = (int)ctx.edx;
-
-                fAspectRatio = (float)iResX / iResY;
-                fAspectMultiplier = fAspectRatio / fNativeAspect;
-
-                // HUD variables
-                fHUDWidth = (float)iResY * fNativeAspect;
-                fHUDHeight = (float)iResY;
-                fHUDWidthOffset = (float)(iResX - fHUDWidth) / 2;
-                fHUDHeightOffset = 0;
-                if (fAspectRatio < fNativeAspect)
+                DIAGNOSTICS_PROBE("CurrentResolutionMidHook");
+                // Repeated calls with an unchanged resolution are coalesced, so nothing is recomputed or logged
+                static std::atomic<uint64_t> iLastResolution{ 0 };
+                uint64_t iResolution = ((uint64_t)ctx.ecx << 32) | ctx.edx;
+                if (iLastResolution.exchange(iResolution) == iResolution)
+                {
+                    return;
+                }
+
+                auto layout = Layout::Compute((int)ctx.ecx, (int)ctx.edx);
+                ResolutionLayout.Store(layout);
+                UpdateConstantPatches(layout);
+                if (hAspectChanged)
                 {
-                    fHUDWidth = (float)iResX;
-                    fHUDHeight = (float)iResX / fNativeAspect;
-                    fHUDWidthOffset = 0;
-                    fHUDHeightOffset = (float)(iResY - fHUDHeight) / 2;
+                    SetEvent(hAspectChanged);
                 }
 
                 // Log aspect ratio stuff
                 spdlog::info("----------");
-                spdlog::info("Current Resolution: Resolution: {}x{}", iResX, iResY);
-                spdlog::info("Current Resolution: fAspectRatio: {}", fAspectRatio);
-                spdlog::info("Current Resolution: fAspectMultiplier: {}", fAspectMultiplier);
-                spdlog::info("Current Resolution: fHUDWidth: {}", fHUDWidth);
-                spdlog::info("Current Resolution: fHUDHeight: {}", fHUDHeight);
-                spdlog::info("Current Resolution: fHUDWidthOffset: {}", fHUDWidthOffset);
-                spdlog::info("Current Resolution: fHUDHeightOffset: {}", fHUDHeightOffset);
+                spdlog::info("Current Resolution: Resolution: {}x{}", layout.iResX, layout.iResY);
+                spdlog::info("Current Resolution: fAspectRatio: {}", layout.fAspectRatio);
+                spdlog::info("Current Resolution: fAspectMultiplier: {}", layout.fAspectMultiplier);
+                spdlog::info("Current Resolution: fHUDWidth: {}", layout.fHUDWidth);
+                spdlog::info("Current Resolution: fHUDHeight: {}", layout.fHUDHeight);
+                spdlog::info("Current Resolution: fHUDWidthOffset: {}", layout.fHUDWidthOffset);
+                spdlog::info("Current Resolution: fHUDHeightOffset: {}", layout.fHUDHeightOffset);
                 spdlog::info("----------");
             });
     }
@@ -197,1396 +400,1715 @@ void GetResolution()
     }
 }
 
-void HUD()
+// HUD Size
+void HUDWidthMidHook(LeanHook::Context<Reg::Xmm0>& ctx)
 {
-    // HUD Size
-    uint8_t* HUDSizeScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? ?? 0F 57 ?? F3 0F ?? ?? 0F 28 ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F 28 ??");
-    if (HUDSizeScanResult)
+    DIAGNOSTICS_PROBE("HUDWidthMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("HUD: HUDSize: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)HUDSizeScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid HUDWidthMidHook{};
-        HUDWidthMidHook = safetyhook::create_mid(HUDSizeScanResult + 0x8,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)iResY;
-                }
-            });
+        ctx.xmm0().f32[0] = (float)layout.iResY;
     }
-    else if (!HUDSizeScanResult)
+}
+
+// xmm0 is loaded from a constant right before the old hook point, so repoint that load instead
+bool HUDWidthConstant(HookBatch& batch, uint8_t* address, Applies applies)
+{
+    if (batch.Create(HUDWidthPatch, address, ZYDIS_REGISTER_XMM0, ModuleImage, applies))
     {
-        spdlog::error("HUD: HUDSize: Pattern scan failed.");
+        spdlog::info("HUD: HUDSize: Patching the width constant in place.");
+        return true;
     }
+    spdlog::warn("HUD: HUDSize: Unexpected instruction, using a mid hook instead of a constant patch.");
+    return Fixes::InstallHook<HUDWidthMidHook>(batch, address + 0x8, applies);
+}
 
-    // HUD Offset
-    uint8_t* HUDOffsetScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? F3 0F ?? ?? ?? 83 ?? ?? FD 8B ?? ?? ?? 48 74 ?? 48 74 ??");
-    if (HUDOffsetScanResult)
+// HUD Offset
+void HUDOffsetMidHook(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("HUDOffsetMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("HUDOffset: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)HUDOffsetScanResult - (uintptr_t)baseModule);
+        ctx.xmm0().f32[0] = -layout.fInverseAspectMultiplier;
+    }
+}
 
-        static SafetyHookMid HUDOffsetMidHook{};
-        HUDOffsetMidHook = safetyhook::create_mid(HUDOffsetScanResult,
-            [](SafetyHookContext& ctx)
+void HUDBackgrounds1MidHook1(LeanHook::Context<Reg::Esi, Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("HUDBackgrounds1MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.esi() + 0xD0)
+    {
+        if ((ctx.xmm1().f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.esi() + 0xD4) == (float)720))
+        {
+            if (layout.aspect == Layout::Aspect::Wider)
             {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)-1 / fAspectMultiplier;
-                }
-            });
+                ctx.xmm1().f32[0] = layout.fCanvasWidth;
+            }
+            else if (layout.aspect == Layout::Aspect::Narrower)
+            {
+                *reinterpret_cast<float*>(ctx.esi() + 0xD4) = layout.fCanvasHeight;
+            }
+        }
     }
-    else if (!HUDOffsetScanResult)
+}
+
+void HUDBackgrounds1MidHook2(LeanHook::Context<Reg::Esi, Reg::Xmm0, Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("HUDBackgrounds1MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.esi() + 0xD0)
     {
-        spdlog::error("HUD: HUDOffset: Pattern scan failed.");
+        if ((ctx.xmm1().f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.esi() + 0xD4) == (float)720))
+        {
+            if (layout.aspect == Layout::Aspect::Wider)
+            {
+                ctx.xmm0().f32[0] = -layout.fHUDWidthOffset;
+                ctx.xmm1().f32[0] = layout.fCanvasWidth;
+            }
+            else if (layout.aspect == Layout::Aspect::Narrower)
+            {
+                *reinterpret_cast<float*>(ctx.esi() + 0xD4) = layout.fCanvasHeight;
+            }
+        }
     }
+}
 
-    uint8_t* HUDBackgrounds1ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? 0C 0F ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ??");
-    uint8_t* HUDBackgrounds2ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? 10 0F ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ??");
-    if (HUDBackgrounds1ScanResult && HUDBackgrounds2ScanResult)
+void HUDBackgrounds2MidHook1(LeanHook::Context<Reg::Edi, Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("HUDBackgrounds2MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.edi() + 0xD0)
     {
-        spdlog::info("HUD: HUDBackgrounds: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)HUDBackgrounds1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("HUD: HUDBackgrounds: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)HUDBackgrounds2ScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid HUDBackgrounds1MidHook1{};
-        HUDBackgrounds1MidHook1 = safetyhook::create_mid(HUDBackgrounds1ScanResult + 0x8,
-            [](SafetyHookContext& ctx)
+        // Fix pesky blue dot at the top of HUD
+        if ((ctx.xmm1().f32[0] == (float)24) && (*reinterpret_cast<float*>(ctx.edi() + 0xD4) == (float)24) && (*reinterpret_cast<int*>(ctx.edi() + 0xCC) == 0xFFF06E5A))
+        {
+            if (layout.aspect == Layout::Aspect::Narrower)
             {
-                if (ctx.esi + 0xD0)
-                {
-                    if ((ctx.xmm1.f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.esi + 0xD4) == (float)720))
-                    {
-                        if (fAspectRatio > fNativeAspect)
-                        {
-                            ctx.xmm1.f32[0] = (float)720 * fAspectRatio;
-                        }
-                        else if (fAspectRatio < fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.esi + 0xD4) = (float)1280 / fAspectRatio;
-                        }
-                    }
-                }
-            });
+                ctx.xmm1().f32[0] = 0.0f;
+                *reinterpret_cast<float*>(ctx.edi() + 0xD4) = 0.0f;
+            }
+        }
 
-        static SafetyHookMid HUDBackgrounds1MidHook2{};
-        HUDBackgrounds1MidHook2 = safetyhook::create_mid(HUDBackgrounds1ScanResult + 0x1F,
-            [](SafetyHookContext& ctx)
+        if ((ctx.xmm1().f32[0] == (float)1280) && (*reinterpret_cast<float*>(ctx.edi() + 0xD4) == (float)720))
+        {
+            if (layout.aspect == Layout::Aspect::Wider)
             {
-                if (ctx.esi + 0xD0)
-                {
-                    if ((ctx.xmm1.f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.esi + 0xD4) == (float)720))
-                    {
-                        if (fAspectRatio > fNativeAspect)
-                        {
-                            ctx.xmm0.f32[0] = -fHUDWidthOffset;
-                            ctx.xmm1.f32[0] = (float)720 * fAspectRatio;
-                        }
-                        else if (fAspectRatio < fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.esi + 0xD4) = (float)1280 / fAspectRatio;
-                        }
-                    }
-                }
-            });
-
-        static SafetyHookMid HUDBackgrounds2MidHook1{};
-        HUDBackgrounds2MidHook1 = safetyhook::create_mid(HUDBackgrounds2ScanResult + 0x8,
-            [](SafetyHookContext& ctx)
+                ctx.xmm1().f32[0] = layout.fCanvasWidth;
+            }
+            else if (layout.aspect == Layout::Aspect::Narrower)
             {
-                if (ctx.edi + 0xD0)
-                {
-                    // Fix pesky blue dot at the top of HUD
-                    if ((ctx.xmm1.f32[0] == (float)24) && (*reinterpret_cast<float*>(ctx.edi + 0xD4) == (float)24) && (*reinterpret_cast<int*>(ctx.edi + 0xCC) == 0xFFF06E5A))
-                    {
-                        if (fAspectRatio < fNativeAspect)
-                        {
-                            ctx.xmm1.f32[0] = 0.0f;
-                            *reinterpret_cast<float*>(ctx.edi + 0xD4) = 0.0f;
-                        }
-                    }
-
-                    if ((ctx.xmm1.f32[0] == (float)1280) && (*reinterpret_cast<float*>(ctx.edi + 0xD4) == (float)720))
-                    {
-                        if (fAspectRatio > fNativeAspect)
-                        {
-                            ctx.xmm1.f32[0] = (float)720 * fAspectRatio;
-                        }
-                        else if (fAspectRatio < fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.edi + 0xD4) = (float)1280 / fAspectRatio;
-                        }
-                    }
-                }
-            });
+                *reinterpret_cast<float*>(ctx.edi() + 0xD4) = layout.fCanvasHeight;
+            }
+        }
+    }
+}
 
-        // This one spans certain menu backgrounds but it also spans the capcom logo and maybe more?
-        /*
-        static SafetyHookMid HUDBackgrounds2MidHook2{};
-        HUDBackgrounds2MidHook2 = safetyhook::create_mid(HUDBackgrounds2ScanResult + 0x1F,
-            [](SafetyHookContext& ctx)
+// This one spans certain menu backgrounds but it also spans the capcom logo and maybe more?
+/*
+void HUDBackgrounds2MidHook2(LeanHook::Context<Reg::Edi, Reg::Xmm0, Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("HUDBackgrounds2MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.edi() + 0xD0)
+    {
+        if ((ctx.xmm1().f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.edi() + 0xD4) == (float)720))
+        {
+            if (layout.aspect == Layout::Aspect::Wider)
             {
-                if (ctx.edi + 0xD0)
-                {
-                    if ((ctx.xmm1.f32[0] == (float)1280 && *reinterpret_cast<float*>(ctx.edi + 0xD4) == (float)720))
-                    {
-                        if (fAspectRatio > fNativeAspect)
-                        {
-                            ctx.xmm0.f32[0] = -fHUDWidthOffset;
-                            ctx.xmm1.f32[0] = (float)720 * fAspectRatio;
-                        }
-                        else if (fAspectRatio < fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.edi + 0xD4) = (float)1280 / fAspectRatio;
-                        }
-                    }
-                }
-            });
-        */
+                ctx.xmm0().f32[0] = -layout.fHUDWidthOffset;
+                ctx.xmm1().f32[0] = layout.fCanvasWidth;
+            }
+            else if (layout.aspect == Layout::Aspect::Narrower)
+            {
+                *reinterpret_cast<float*>(ctx.edi() + 0xD4) = layout.fCanvasHeight;
+            }
+        }
     }
-    else if (!HUDBackgrounds1ScanResult || !HUDBackgrounds2ScanResult)
+}
+*/
+
+// Subtitles
+void SubtitlesLayerMidHook(LeanHook::Context<Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("SubtitlesLayerMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm1().f32[0] = layout.fHUDWidth;
+    } 
+}
+
+// Title background
+void TitleBackgroundMidHook(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("TitleBackgroundMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect != Layout::Aspect::Native)
     {
-        spdlog::error("HUD: HUDBackgrounds: Pattern scan failed.");
+        ctx.xmm0().f32[0] = 1.0f;
     }
-    
-    // Subtitles 
-    uint8_t* SubtitlesLayerScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? 2B ?? 8B ?? 2B ?? ?? ?? F3 0F ?? ?? ?? ??");
-    if (SubtitlesLayerScanResult)
+}
+
+// Same as HUDSize, the instruction before the old hook point loads xmm0
+bool TitleBackgroundConstant(HookBatch& batch, uint8_t* address, Applies applies)
+{
+    if (batch.Create(TitleBackgroundPatch, address, ZYDIS_REGISTER_XMM0, ModuleImage, applies))
     {
-        spdlog::info("HUD: SubtitlesLayer: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)SubtitlesLayerScanResult - (uintptr_t)baseModule);
+        spdlog::info("HUD: TitleBackground: Patching the scale constant in place.");
+        return true;
+    }
+    spdlog::warn("HUD: TitleBackground: Unexpected instruction, using a mid hook instead of a constant patch.");
+    return Fixes::InstallHook<TitleBackgroundMidHook>(batch, address + 0x8, applies);
+}
 
-        static SafetyHookMid SubtitlesLayerMidHook{};
-        SubtitlesLayerMidHook = safetyhook::create_mid(SubtitlesLayerScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = fHUDWidth;
-                } 
-            });
+// Reported mouse position
+void MousePosXMidHook(LeanHook::Context<Reg::Eax>& ctx)
+{
+    DIAGNOSTICS_PROBE("MousePosXMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.eax() -= layout.iHUDWidthOffset;
     }
-    else if (!SubtitlesLayerScanResult)
+}
+
+void MapMousePos1MidHook(LeanHook::Context<Reg::Edx>& ctx)
+{
+    DIAGNOSTICS_PROBE("MapMousePos1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("HUD: SubtitlesLayer: Pattern scan failed.");
+        ctx.edx() -= layout.iHUDWidthOffset;
     }
+}
 
-    // Title background
-    uint8_t* TitleBackgroundScanResult = Memory::PatternScan(baseModule, "0F 57 ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 14 F3 0F ?? ?? ?? 10 F3 0F ?? ?? ?? F3 0F ?? ?? ?? ??");
-    if (TitleBackgroundScanResult)
+void MapMousePos3MidHook(LeanHook::Context<Reg::Ecx>& ctx)
+{
+    DIAGNOSTICS_PROBE("MapMousePos3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("HUD: TitleBackground: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)TitleBackgroundScanResult - (uintptr_t)baseModule);
+        ctx.ecx() += layout.iHUDWidthOffset;
+    }
+}
 
-        static SafetyHookMid TitleBackgroundMidHook{};
-        TitleBackgroundMidHook = safetyhook::create_mid(TitleBackgroundScanResult + 0x17,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio != fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = 1.0f;
-                }
-            });
+void MapMousePos4MidHook(LeanHook::Context<Reg::Ecx>& ctx)
+{
+    DIAGNOSTICS_PROBE("MapMousePos4MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.ecx() += layout.iHUDWidthOffset;
     }
-    else if (!TitleBackgroundScanResult)
+}
+
+// Mouse position in menus
+void MenuMouse1MidHook1(LeanHook::Context<Reg::Xmm3>& ctx)
+{
+    DIAGNOSTICS_PROBE("MenuMouse1MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("HUD: TitleBackground: Pattern scan failed.");
+        ctx.xmm3().f32[0] = layout.fCanvasWidth;
     }
+}
 
+void MenuMouse1MidHook2(LeanHook::Context<Reg::Xmm2>& ctx)
+{
+    DIAGNOSTICS_PROBE("MenuMouse1MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm2().f32[0] = layout.fHUDWidth;
+    }
 }
 
-void MouseInput()
+void MenuMouse2MidHook1(LeanHook::Context<Reg::Xmm3>& ctx)
 {
-    // Reported mouse position
-    uint8_t* MousePosScanResult = Memory::PatternScan(baseModule, "99 F7 ?? 8B ?? ?? ?? 89 ?? 8B ?? ?? ?? 2B ?? 0F ?? ?? ?? ?? 99 F7 ??") + 0x7;
-    uint8_t* MapMousePos1ScanResult = Memory::PatternScan(baseModule, "89 ?? 8B ?? ?? 5E 5D 89 ?? ?? 5B 83 ?? ?? C2 08 00");
-    uint8_t* MapMousePos3ScanResult = Memory::PatternScan(baseModule, "89 ?? ?? ?? 8D ?? ?? ?? 8B ?? 89 ?? ?? ?? E8 ?? ?? ?? ?? A1 ?? ?? ?? ??");
-    uint8_t* MapMousePos4ScanResult = Memory::PatternScan(baseModule, "89 ?? ?? ?? 8D ?? ?? ?? 8B ?? 89 ?? ?? ?? E8 ?? ?? ?? ?? 8B ?? ?? ?? 8B ?? ?? ?? ?? ?? 8B ?? 8B ?? ??");
-    if (MousePosScanResult && MapMousePos1ScanResult && MapMousePos3ScanResult && MapMousePos4ScanResult)
-    {
-        spdlog::info("MouseInput: MousePos: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MousePosScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: MapMousePos: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapMousePos1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: MapMousePos: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapMousePos3ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: MapMousePos: 4: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapMousePos4ScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid MousePosXMidHook{};
-        MousePosXMidHook = safetyhook::create_mid(MousePosScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.eax -= (int)fHUDWidthOffset;
-                }
-            });
+    DIAGNOSTICS_PROBE("MenuMouse2MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm3().f32[0] = layout.fCanvasWidth;
+    }
+}
 
-        static SafetyHookMid MapMousePos1MidHook{};
-        MapMousePos1MidHook = safetyhook::create_mid(MapMousePos1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.edx -= (int)fHUDWidthOffset;
-                }
-            });
+void MenuMouse2MidHook2(LeanHook::Context<Reg::Xmm2>& ctx)
+{
+    DIAGNOSTICS_PROBE("MenuMouse2MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm2().f32[0] = layout.fHUDWidth;
+    }
+}
 
-        static SafetyHookMid MapMousePos3MidHook{};
-        MapMousePos3MidHook = safetyhook::create_mid(MapMousePos3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.ecx += (int)fHUDWidthOffset;
-                }
-            });
+void MenuMouse3MidHook(LeanHook::Context<Reg::Xmm4>& ctx)
+{
+    DIAGNOSTICS_PROBE("MenuMouse3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm4().f32[0] = layout.fHUDWidth;
+    }
+}
 
-        static SafetyHookMid MapMousePos4MidHook{};
-        MapMousePos4MidHook = safetyhook::create_mid(MapMousePos4ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.ecx += (int)fHUDWidthOffset;
-                }
-            });
+// Vert scroll bar 1
+void Scrollbar1MidHook1(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar1MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0().f32[0] = layout.fHUDWidth;
     }
-    else if (!MousePosScanResult || !MapMousePos1ScanResult || !MapMousePos3ScanResult || !MapMousePos4ScanResult)
+}
+
+// Vert scroll bar 2
+void Scrollbar1MidHook2(LeanHook::Context<Reg::Xmm2>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar1MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("MouseInput: MousePos: Pattern scan failed.");
+        ctx.xmm2().f32[0] = layout.fCanvasWidth;
     }
+}
 
-    // Mouse position in menus
-    uint8_t* MenuMouse1ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F 57 ?? F3 0F ?? ?? F3 0F ?? ??");
-    uint8_t* MenuMouse2ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 56 8B ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F 57 ?? F3 0F ?? ??");
-    uint8_t* MenuMouse3ScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 0F 57 ?? 8B ?? ?? 83 ?? FF");
-    if (MenuMouse1ScanResult && MenuMouse2ScanResult && MenuMouse3ScanResult)
+// Horizontal scroll bars
+void Scrollbar2MidHook(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("MouseInput: MenuMouse: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MenuMouse1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: MenuMouse: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MenuMouse2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: MenuMouse: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MenuMouse3ScanResult - (uintptr_t)baseModule);
+        ctx.xmm0().f32[0] = layout.fCanvasWidth;
+    }
+}
 
-        static SafetyHookMid MenuMouse1MidHook1{};
-        MenuMouse1MidHook1 = safetyhook::create_mid(MenuMouse1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+// Vert scroll bar 3
+void Scrollbar3MidHook1(LeanHook::Context<Reg::Xmm1>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar3MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm1().f32[0] = layout.fCanvasWidth;
+    }
+}
 
-        static SafetyHookMid MenuMouse1MidHook2{};
-        MenuMouse1MidHook2 = safetyhook::create_mid(MenuMouse1ScanResult + 0x2F,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] = fHUDWidth;
-                }
-            });
+// Vert scroll bar 4
+void Scrollbar3MidHook2(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar3MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0().f32[0] = layout.fHUDWidth;
+    }
+}
 
-        static SafetyHookMid MenuMouse2MidHook1{};
-        MenuMouse2MidHook1 = safetyhook::create_mid(MenuMouse2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+// Vert scroll bars again
+void Scrollbar4MidHook1(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar4MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0().f32[0] = layout.fHUDWidth;
+    }
+}
 
-        static SafetyHookMid MenuMouse2MidHook2{};
-        MenuMouse2MidHook2 = safetyhook::create_mid(MenuMouse2ScanResult + 0x32,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] = fHUDWidth;
-                }
-            });
+// Vert scroll bars again
+void Scrollbar4MidHook2(LeanHook::Context<Reg::Xmm2>& ctx)
+{
+    DIAGNOSTICS_PROBE("Scrollbar4MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm2().f32[0] = layout.fCanvasWidth;
+    }
+}
 
-        static SafetyHookMid MenuMouse3MidHook{};
-        MenuMouse3MidHook = safetyhook::create_mid(MenuMouse3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm4.f32[0] = fHUDWidth;
-                }
-            });
+// Interaction markers
+void MarkersWidthMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MarkersWidthMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] *= layout.fCanvasWidthScale;
     }
-    else if (!MenuMouse1ScanResult || !MenuMouse2ScanResult || !MenuMouse3ScanResult)
+}
+
+void MarkersHeightMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MarkersHeightMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm1.f32[0] *= layout.fCanvasHeightScale;
+    }
+}
+
+void MarkersOffsetMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MarkersOffsetMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("MouseInput: MenuMouse: Pattern scan failed.");
+        ctx.xmm0.f32[0] -= layout.fCanvasWidthOffset;
     }
- 
-    uint8_t* Scrollbar1ScanResult = Memory::PatternScan(baseModule, "0F 28 ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 75 ??") + 0x3;
-    uint8_t* Scrollbar2ScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 8B ?? ?? ?? 0F 5B ??") + 0x10;
-    uint8_t* Scrollbar3ScanResult = Memory::PatternScan(baseModule, "0F 57 ?? F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ??");
-    uint8_t* Scrollbar4ScanResult = Memory::PatternScan(baseModule, "0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 75 ?? 85 ??") + 0x3;
-    if (Scrollbar1ScanResult && Scrollbar2ScanResult && Scrollbar3ScanResult && Scrollbar4ScanResult)
+    else if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::info("MouseInput: Scrollbar: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)Scrollbar1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: Scrollbar: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)Scrollbar2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: Scrollbar: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)Scrollbar3ScanResult - (uintptr_t)baseModule);
-        spdlog::info("MouseInput: Scrollbar: 4: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)Scrollbar3ScanResult - (uintptr_t)baseModule);
+        ctx.xmm1.f32[0] -= layout.fCanvasHeightOffset;
+    }
+}
 
-        // Vert scroll bar 1
-        static SafetyHookMid Scrollbar1MidHook1{};
-        Scrollbar1MidHook1 = safetyhook::create_mid(Scrollbar1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = fHUDWidth;
-                }
-            });
+// Minimap width multiplier
+void MinimapWidthMultiMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapWidthMultiMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] = layout.fHUDWidth;
+    }
+}
 
-        // Vert scroll bar 2
-        static SafetyHookMid Scrollbar1MidHook2{};
-        Scrollbar1MidHook2 = safetyhook::create_mid(Scrollbar1ScanResult + 0x25,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+// Minimap texture size and position
+void MinimapTexture1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapTexture1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm3.f32[0] = layout.fMinimapSize;
+    }
+}
 
-        // Horizontal scroll bars
-        static SafetyHookMid Scrollbar2MidHook{};
-        Scrollbar2MidHook = safetyhook::create_mid(Scrollbar2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+void MinimapTexture2MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapTexture2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm3.f32[0] = layout.fMinimapSize;
+    }
+}
 
-        // Vert scroll bar 3
-        static SafetyHookMid Scrollbar3MidHook1{};
-        Scrollbar1MidHook1 = safetyhook::create_mid(Scrollbar3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+void MinimapTexturePositionMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapTexturePositionMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        if (ctx.edx + 0x24)
+        {
+            *reinterpret_cast<float*>(ctx.edx + 0x24) = layout.fMinimapSize;
+        }
+    }
+}
 
-        // Vert scroll bar 4
-        static SafetyHookMid Scrollbar3MidHook2{};
-        Scrollbar1MidHook2 = safetyhook::create_mid(Scrollbar3ScanResult + 0x17,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = fHUDWidth;
-                }
-            });
+// Minimap fog
+void MinimapFog1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapFog1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm1.f32[0] = layout.fMinimapSize;
+    }
+}
 
-        // Vert scroll bars again
-        static SafetyHookMid Scrollbar4MidHook1{};
-        Scrollbar4MidHook1 = safetyhook::create_mid(Scrollbar4ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = fHUDWidth;
-                }
-            });
+void MinimapFog2MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapFog2MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm4.f32[0] = layout.fMinimapSize;
+    }
+}
 
-        // Vert scroll bars again
-        static SafetyHookMid Scrollbar4MidHook2{};
-        Scrollbar4MidHook2 = safetyhook::create_mid(Scrollbar4ScanResult + 0x25,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] = (float)720 * fAspectRatio;
-                }
-            });
+void MinimapFog2MidHook2(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapFog2MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm1.f32[0] = layout.fMinimapSize;
     }
-    else if (!Scrollbar1ScanResult || !Scrollbar2ScanResult || !Scrollbar3ScanResult || !Scrollbar4ScanResult)
+}
+
+// Minimap icons height offset
+void MinimapIconHeightOffsetMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapIconHeightOffsetMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect != Layout::Aspect::Native)
     {
-        spdlog::error("MouseInput: Scrollbar: Pattern scan failed.");
+        if (ctx.esi + 0x500)
+        {
+            *reinterpret_cast<float*>(ctx.esi + 0x500) = 0.0f;
+        }
     }
 }
 
-void Markers()
+// Minimap height offset
+void MinimapHeightOffsetMidHook(SafetyHookContext& ctx)
 {
-    // Interaction markers
-    uint8_t* MarkersScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 00 0F 57 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ??");
-    if (MarkersScanResult)
+    DIAGNOSTICS_PROBE("MinimapHeightOffsetMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Markers: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MarkersScanResult - (uintptr_t)baseModule);
-        
-        static SafetyHookMid MarkersWidthMidHook{};
-        MarkersWidthMidHook = safetyhook::create_mid(MarkersScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] /= (float)1280;
-                    ctx.xmm0.f32[0] *= (float)720 * fAspectRatio;
-                }
-            });
+        ctx.xmm3.f32[0] = layout.fHUDWidth;
+    }
+}
 
-        static SafetyHookMid MarkersHeightMidHook{};
-        MarkersHeightMidHook = safetyhook::create_mid(MarkersScanResult + 0x28,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] /= (float)720;
-                    ctx.xmm1.f32[0] *= (float)1280 / fAspectRatio;
-                }
-            });
+// Minimap width offset
+// Minimap quest marker
+void MinimapWidthOffset1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapWidthOffset1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        if (ctx.edi + 0x468)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x468) = layout.iMinimapWidthOffset;
+        }
+    }
+    else if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        if (ctx.edi + 0x46C)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x46C) = layout.iMinimapMarkerHeightOffset;
+        }
+    }
+}
 
-        static SafetyHookMid MarkersOffsetMidHook{};
-        MarkersOffsetMidHook = safetyhook::create_mid(MarkersScanResult + 0x30,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
-                }
-            });   
+// Minimap ring
+void MinimapWidthOffset2MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapWidthOffset2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        if (ctx.eax + 0x468)
+        {
+            *reinterpret_cast<int*>(ctx.eax + 0x468) = layout.iMinimapRingWidthOffset;
+        }
     }
-    else if (!MarkersScanResult)
+    else if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Markers: Pattern scan failed.");
+        if (ctx.eax + 0x46C)
+        {
+            *reinterpret_cast<int*>(ctx.eax + 0x46C) = layout.iMinimapHeightOffset;
+        }
     }
 }
 
-void Minimap()
+// Minimap pawn marker
+void MinimapWidthOffset3MidHook(SafetyHookContext& ctx)
 {
-    // Minimap width multiplier
-    uint8_t* MinimapWidthMultiScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 D9 ?? ??") + 0xB;
-    if (MinimapWidthMultiScanResult)
+    DIAGNOSTICS_PROBE("MinimapWidthOffset3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        if (ctx.edi + 0x468)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x468) = layout.iMinimapWidthOffset;
+        }
+    }
+    else if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::info("Minimap: MinimapWidthMulti: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapWidthMultiScanResult - (uintptr_t)baseModule);
+        if (ctx.edi + 0x46C)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x46C) = layout.iMinimapMarkerHeightOffset;
+        }
+    }
+}
 
-        static SafetyHookMid MinimapWidthMultiMidHook{};
-        MinimapWidthMultiMidHook = safetyhook::create_mid(MinimapWidthMultiScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = fHUDWidth;
-                }
-            });
+// Minimap player marker
+void MinimapWidthOffset4MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MinimapWidthOffset4MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        if (ctx.edi + 0x468)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x468) = layout.iMinimapWidthOffset;
+        }
     }
-    else if (!MinimapWidthMultiScanResult)
+    else if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Minimap: MinimapWidthMulti: Pattern scan failed.");
+        if (ctx.edi + 0x46C)
+        {
+            *reinterpret_cast<int*>(ctx.edi + 0x46C) = layout.iMinimapMarkerHeightOffset;
+        }
     }
+}
 
-    // Minimap texture size and position
-    uint8_t* MinimapTextureScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 8B ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ?? ?? 89 ?? ?? ??") + 0x8;
-    uint8_t* MinimapTexturePositionScanResult = Memory::PatternScan(baseModule, "D9 ?? ?? 8B ?? ?? ?? ?? 00 8B ?? 68 ?? ?? ?? ?? 57") + 0x3;
-    if (MinimapTextureScanResult && MinimapTexturePositionScanResult)
+// Map frame
+void MapFrameMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapFrameMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Minimap: MinimapTexture: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapTextureScanResult - (uintptr_t)baseModule);
-        spdlog::info("Minimap: MinimapTexture: Position: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapTexturePositionScanResult - (uintptr_t)baseModule);
+        ctx.ecx = (uint32_t)layout.iHUDWidth;
+    }
+}
 
-        static SafetyHookMid MinimapTexture1MidHook{};
-        MinimapTexture1MidHook = safetyhook::create_mid(MinimapTextureScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)iResX * fDefMinimapMulti;
-                }
-            });
+// Map location menu
+void MapLocationMenuMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapLocationMenuMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.ecx = (uint32_t)layout.iHUDWidth;
+    }
+}
 
-        static SafetyHookMid MinimapTexture2MidHook{};
-        MinimapTexture2MidHook = safetyhook::create_mid(MinimapTextureScanResult + 0x92, // Big gap, maybe do a second pattern?
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)iResX * fDefMinimapMulti;
-                }
-            });
+// Map position hor offset
+void MapPosOffsetHorMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapPosOffsetHorMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm6.f32[0] = layout.fHUDWidthOffset;
+    }
+}
 
-        static SafetyHookMid MinimapTexturePositionMidHook{};
-        MinimapTexturePositionMidHook = safetyhook::create_mid(MinimapTexturePositionScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    if (ctx.edx + 0x24)
-                    {
-                        *reinterpret_cast<float*>(ctx.edx + 0x24) = (float)iResX * fDefMinimapMulti;
-                    }
-                }
-            });
+// Map cursor boundary
+void MapCursor1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursor1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] = layout.fHUDWidth;
     }
-    else if (!MinimapTextureScanResult || !MinimapTexturePositionScanResult)
+    else if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Minimap: MinimapTexture: Pattern scan failed.");
+        ctx.xmm0.f32[0] = layout.fMapCursorWidth;
     }
+}
 
-    // Minimap fog
-    uint8_t* MinimapFog1ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ??  0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ??");
-    uint8_t* MinimapFog2ScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F 59 ?? ?? ?? ?? ??");
-    if (MinimapFog1ScanResult && MinimapFog2ScanResult)
+void MapCursor2MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursor2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Minimap: MinimapFog: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapFog1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Minimap: MinimapFog: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapFog2ScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid MinimapFog1MidHook{};
-        MinimapFog1MidHook = safetyhook::create_mid(MinimapFog1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = (float)iResX * fDefMinimapMulti;
-                }
-            });
+        ctx.xmm5.f32[0] = layout.fHUDWidth;
+    }
+    else if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm5.f32[0] = layout.fMapCursorWidth;
+    }
+}
 
-        static SafetyHookMid MinimapFog2MidHook1{};
-        MinimapFog2MidHook1 = safetyhook::create_mid(MinimapFog2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm4.f32[0] = (float)iResX * fDefMinimapMulti;
-                }
-            });
+void MapCursor3MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursor3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm1.f32[0] = layout.fHUDWidth;
+    }
+    else if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm1.f32[0] = layout.fMapCursorWidth;
+    }
+}
 
-        static SafetyHookMid MinimapFog2MidHook2{};
-        MinimapFog2MidHook2 = safetyhook::create_mid(MinimapFog2ScanResult + 0x21,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = (float)iResX * fDefMinimapMulti;
-                }
-            });
+// Map cursor offset
+void MapCursorOffset1MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset1MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] -= layout.fHUDWidthOffset;
     }
-    else if (!MinimapFog1ScanResult || !MinimapFog2ScanResult)
+}
+
+void MapCursorOffset1MidHook2(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset1MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Minimap: MinimapFog: Pattern scan failed.");
+        ctx.xmm0.f32[0] -= layout.fHUDHeightOffset;
     }
+}
 
-    // Minimap icons height offset
-    uint8_t* MinimapIconHeightOffsetScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 83 ?? ?? 01 8B ?? ?? F3 0F ?? ?? F3 0F ?? ??");
-    if (MinimapIconHeightOffsetScanResult)
+void MapCursorOffset2MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset2MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Minimap: MinimapIconHeightOffset: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapIconHeightOffsetScanResult - (uintptr_t)baseModule);
+        ctx.xmm0.f32[0] -= layout.fHUDWidthOffset;
+    }
+}
 
-        static SafetyHookMid MinimapIconHeightOffsetMidHook{};
-        MinimapIconHeightOffsetMidHook = safetyhook::create_mid(MinimapIconHeightOffsetScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio != fNativeAspect)
-                {
-                    if (ctx.esi + 0x500)
-                    {
-                        *reinterpret_cast<float*>(ctx.esi + 0x500) = 0.0f;
-                    }
-                }
-            });
+void MapCursorOffset2MidHook2(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset2MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm1.f32[0] -= layout.fHUDHeightOffset;
     }
-    else if (!MinimapIconHeightOffsetScanResult)
+}
+
+void MapCursorOffset3MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset3MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("Minimap: MinimapIconHeightOffset: Pattern scan failed.");
+        ctx.xmm3.f32[0] -= layout.fHUDWidthOffset;
     }
+}
 
-    // Minimap height offset
-    uint8_t* MinimapHeightOffsetScanResult = Memory::PatternScan(baseModule, "0F 57 ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F 57 ?? 0F 57 ??") + 0x7;
-    if (MinimapHeightOffsetScanResult)
+void MapCursorOffset3MidHook2(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapCursorOffset3MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::info("Minimap: MinimapHeightOffset: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapHeightOffsetScanResult - (uintptr_t)baseModule);
+        ctx.xmm0.f32[0] -= layout.fHUDHeightOffset;
+    }
+}
 
-        static SafetyHookMid MinimapHeightOffsetMidHook{};
-        MinimapHeightOffsetMidHook = safetyhook::create_mid(MinimapHeightOffsetScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = fHUDWidth;
-                }
-            });
+// Map icons width offset
+void MapIconWidthOffset1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconWidthOffset1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm2.f32[0] -= layout.fCanvasWidthOffset;
     }
-    else if (!MinimapHeightOffsetScanResult)
+}
+
+void MapIconHeightOffset1MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconHeightOffset1MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Minimap: MinimapHeightOffset: Pattern scan failed.");
+        ctx.xmm0.f32[0] -= layout.fCanvasHeightOffset;
     }
+}
 
-    // Minimap width offset
-    uint8_t* MinimapWidthOffset1ScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 0F 28 ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 0F 28 ?? 0F 57 ?? ?? ?? ?? ??");
-    uint8_t* MinimapWidthOffset2ScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 0F 5B ?? F3 0F ?? ?? ?? ?? 66 0F ?? ?? ?? ?? ?? 00 0F 5B ??");
-    uint8_t* MinimapWidthOffset3ScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? 0F 28 ?? F3 0F 59 ?? ?? ?? F3 0F 59 ?? ?? ??");
-    uint8_t* MinimapWidthOffset4ScanResult = Memory::PatternScan(baseModule, "66 0F ?? ?? ?? ?? ?? 00 F3 0F 10 ?? ?? ?? ?? ?? F3 0F 5E ?? ?? ?? ?? 00 F3 0F 10 ?? ?? ?? ?? ??");
-    if (MinimapWidthOffset1ScanResult && MinimapWidthOffset2ScanResult && MinimapWidthOffset3ScanResult && MinimapWidthOffset4ScanResult)
-    {
-        spdlog::info("Minimap: MinimapWidthOffset: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapWidthOffset1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Minimap: MinimapWidthOffset: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapWidthOffset2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Minimap: MinimapWidthOffset: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapWidthOffset3ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Minimap: MinimapWidthOffset: 4: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MinimapWidthOffset4ScanResult - (uintptr_t)baseModule);
-
-        // Minimap quest marker
-        static SafetyHookMid MinimapWidthOffset1MidHook{};
-        MinimapWidthOffset1MidHook = safetyhook::create_mid(MinimapWidthOffset1ScanResult - 0x8,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
-                    if (ctx.edi + 0x468)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x468) = (int)floorf(iOrigMinimapWidthOffset / fAspectMultiplier);
-                    }
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    iOrigMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - fHUDHeight) / 2);
-                    if (ctx.edi + 0x46C)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x46C) = (int)floorf(iOrigMinimapHeightOffset - ((iResY - fHUDHeight) / 2));
-                    }
-                }
-            });
-        
-        // Minimap ring
-        static SafetyHookMid MinimapWidthOffset2MidHook{};
-        MinimapWidthOffset2MidHook = safetyhook::create_mid(MinimapWidthOffset2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
-                    if (ctx.eax + 0x468)
-                    {
-                        *reinterpret_cast<int*>(ctx.eax + 0x468) = (int)floorf((iOrigMinimapWidthOffset / fAspectMultiplier) + fHUDWidthOffset);
-                    }
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    iOrigMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - fHUDHeight) / 2);
-                    if (ctx.eax + 0x46C)
-                    {
-                        *reinterpret_cast<int*>(ctx.eax + 0x46C) = iOrigMinimapHeightOffset;
-                    }
-                }
-            });
+void MapIconWidthOffset2MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconWidthOffset2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm2.f32[0] -= layout.fCanvasWidthOffset;
+    }
+}
 
-        // Minimap pawn marker
-        static SafetyHookMid MinimapWidthOffset3MidHook{};
-        MinimapWidthOffset3MidHook = safetyhook::create_mid(MinimapWidthOffset3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
-                    if (ctx.edi + 0x468)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x468) = (int)floorf(iOrigMinimapWidthOffset / fAspectMultiplier);
-                    }
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    iOrigMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - fHUDHeight) / 2);
-                    if (ctx.edi + 0x46C)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x46C) = (int)floorf(iOrigMinimapHeightOffset - ((iResY - fHUDHeight) / 2));
-                    }
-                }
-            });  
+void MapIconHeightOffset2MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconHeightOffset2MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm0.f32[0] -= layout.fCanvasHeightOffset;
+    }
+}
 
-        // Minimap player marker
-        static SafetyHookMid MinimapWidthOffset4MidHook{};
-        MinimapWidthOffset4MidHook = safetyhook::create_mid(MinimapWidthOffset4ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
-                    if (ctx.edi + 0x468)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x468) = (int)floorf(iOrigMinimapWidthOffset / fAspectMultiplier);
-                    }
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    iOrigMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - fHUDHeight) / 2);
-                    if (ctx.edi + 0x46C)
-                    {
-                        *reinterpret_cast<int*>(ctx.edi + 0x46C) = (int)floorf(iOrigMinimapHeightOffset - ((iResY - fHUDHeight) / 2));
-                    }
-                }
-            });
+void MapIconWidthOffset3MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconWidthOffset3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] -= layout.fCanvasWidthOffset;
     }
-    else if (!MinimapWidthOffset1ScanResult || !MinimapWidthOffset2ScanResult || !MinimapWidthOffset3ScanResult || !MinimapWidthOffset4ScanResult)
+}
+
+void MapIconHeightOffset3MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconHeightOffset3MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::error("Minimap: MinimapWidthOffset: Pattern scan failed.");
+        ctx.xmm0.f32[0] -= layout.fCanvasHeightOffset;
     }
 }
 
-void Map()
+void MapIconWidthOffset4MidHook(SafetyHookContext& ctx)
 {
-    // Map frame
-    uint8_t* MapFrameScanResult = Memory::PatternScan(baseModule, "A1 ?? ?? ?? ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F ?? ?? F3 0F ?? ?? 0F 28 ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F 59 0D ?? ?? ?? ??");
-    if (MapFrameScanResult)
+    DIAGNOSTICS_PROBE("MapIconWidthOffset4MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Map: MapFrame: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapFrameScanResult - (uintptr_t)baseModule);
+        ctx.xmm2.f32[0] -= layout.fCanvasWidthOffset;
+    }
+}
 
-        static SafetyHookMid MapFrameMidHook{};
-        MapFrameMidHook = safetyhook::create_mid(MapFrameScanResult + 0x11,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    int iHUDWidth = (int)fHUDWidth;
-                    ctx.ecx = *(uint32_t*)&iHUDWidth;
-                }
-            });
+void MapIconHeightOffset4MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconHeightOffset4MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm0.f32[0] -= layout.fCanvasHeightOffset;
     }
-    else if (!MapFrameScanResult)
+}
+
+void MapIconWidthOffset5MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconWidthOffset5MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("Map: MapFrame: Pattern scan failed.");
+        ctx.xmm1.f32[0] -= layout.fCanvasWidthOffset;
     }
+}
 
-    // Map location menu
-    uint8_t* MapLocationMenuScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? 0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? 89 ?? ?? ?? 8B ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ?? 74 ?? 8B ?? ?? ?? ?? 00 EB ?? 33 ??");
-    if (MapLocationMenuScanResult)
+void MapIconHeightOffset5MidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapIconHeightOffset5MidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
     {
-        spdlog::info("Map: MapLocationMenu: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapLocationMenuScanResult - (uintptr_t)baseModule);
+        ctx.xmm0.f32[0] -= layout.fCanvasHeightOffset;
+    }
+}
 
-        static SafetyHookMid MapLocationMenuMidHook{};
-        MapLocationMenuMidHook = safetyhook::create_mid(MapLocationMenuScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    int iHUDWidth = (int)fHUDWidth;
-                    ctx.ecx = *(uint32_t*)&iHUDWidth;
-                }
-            });
+// Map Area
+void MapArea1MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea1MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm3.f32[0] = layout.fMapAreaSize;
     }
-    else if (!MapLocationMenuScanResult)
+}
+
+void MapArea1MidHook2(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea1MidHook2");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("Map: MapLocationMenu: Pattern scan failed.");
+        ctx.xmm3.f32[0] = layout.fMapAreaSize;
     }
+}
 
-    // Map position hor offset
-    uint8_t* MapPosOffsetHorScanResult = Memory::PatternScan(baseModule, "E9 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 33 ?? BE ?? ?? ?? 00") + 0x5;
-    if (MapPosOffsetHorScanResult)
+void MapArea2MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea2MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::info("Map: MapPosOffset: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapPosOffsetHorScanResult - (uintptr_t)baseModule);
+        ctx.xmm0.f32[0] = layout.fMapAreaSize;
+    }
+}
 
-        static SafetyHookMid MapPosOffsetHorMidHook{};
-        MapPosOffsetHorMidHook = safetyhook::create_mid(MapPosOffsetHorScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm6.f32[0] = fHUDWidthOffset;
-                }
-            });
+void MapArea3MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea3MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
+    {
+        ctx.xmm0.f32[0] = layout.fMapAreaSize;
     }
-    else if (!MapPosOffsetHorScanResult)
+}
+
+void MapArea4MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea4MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("Map: MapPosOffset: Pattern scan failed.");
+        ctx.xmm6.f32[0] = layout.fMapAreaMulti;
     }
+}
 
-    // Map cursor boundary
-    uint8_t* MapCursor1ScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F 10 ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F 10 ?? ?? ?? ?? 00");
-    uint8_t* MapCursor2ScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? ?? 0F 28 ?? 0F 57 ?? 89 ?? ?? ?? 8B ?? ?? 8B ?? ??");
-    uint8_t* MapCursor3ScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? ?? 0F 5B ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 5C ?? ?? ?? ?? ??");
-    if (MapCursor1ScanResult && MapCursor2ScanResult && MapCursor3ScanResult)
+void MapArea5MidHook1(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MapArea5MidHook1");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.eax + 0xB4)
     {
-        spdlog::info("Map: MapCursor: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursor1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapCursor: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursor2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapCursor: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursor3ScanResult - (uintptr_t)baseModule);
+        // Insert HUD width (wider) or iResX into empty space
+        *reinterpret_cast<int*>(ctx.eax + 0xB4) = layout.iMapAreaWidth;
+    }
+}
 
-        static SafetyHookMid MapCursor1MidHook{};
-        MapCursor1MidHook = safetyhook::create_mid(MapCursor1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = fHUDWidth;
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)iResX / fAspectMultiplier;
-                }
-            });
+// FMVs
+void MovieMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("MovieMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (ctx.eax)
+    {
+        if (layout.aspect == Layout::Aspect::Wider)
+        {
+            *reinterpret_cast<float*>(ctx.eax) = -layout.fInverseAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x10) = -layout.fInverseAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x20) = layout.fInverseAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x30) = layout.fInverseAspectMultiplier;
+        }
+        else if (layout.aspect == Layout::Aspect::Narrower)
+        {
+            *reinterpret_cast<float*>(ctx.eax + 0x04) = layout.fAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x14) = -layout.fAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x24) = layout.fAspectMultiplier;
+            *reinterpret_cast<float*>(ctx.eax + 0x34) = -layout.fAspectMultiplier;
+        }
+    }
+}
 
-        static SafetyHookMid MapCursor2MidHook{};
-        MapCursor2MidHook = safetyhook::create_mid(MapCursor2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm5.f32[0] = fHUDWidth;
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm5.f32[0] = (float)iResX / fAspectMultiplier;
-                }
-            });
+// Aspect ratio
+void AspectRatioMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("AspectRatioMidHook");
+    const auto layout = ResolutionLayout.Load();
+    // Only needed at <16:9
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm0.f32[0] = layout.fInverseAspectRatio;
+    }
+}
 
-        static SafetyHookMid MapCursor3MidHook{};
-        MapCursor3MidHook = safetyhook::create_mid(MapCursor3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = fHUDWidth;
-                }
-                else if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] = (float)iResX / fAspectMultiplier;
-                }
-            });
+/*
+// Gameplay FOV
+uint8_t* GameplayFOVScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? 00 E8 ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? 8B ?? ??");
+if (GameplayFOVScanResult)
+{
+    spdlog::info("AspectFOV: GameplayFOV: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)GameplayFOVScanResult - (uintptr_t)baseModule);
+
+    static SafetyHookMid GameplayFOVMidHook{};
+    Hooks.Create(GameplayFOVMidHook, GameplayFOVScanResult,
+        [](SafetyHookContext& ctx)
+        {
+            DIAGNOSTICS_PROBE("GameplayFOVMidHook");
+        });
+}
+else if (!GameplayFOVScanResult)
+{
+    spdlog::error("AspectFOV: GameplayFOV: Pattern scan failed.");
+}
+*/
+
+// Loading screen aspect ratio
+void LoadingAspectMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("LoadingAspectMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Narrower)
+    {
+        ctx.xmm0.f32[0] = Layout::fNativeAspect;
     }
-    else if (!MapCursor1ScanResult || !MapCursor2ScanResult)
+}
+
+// Cutscene FOV
+void CutsceneFOVMidHook(SafetyHookContext& ctx)
+{
+    DIAGNOSTICS_PROBE("CutsceneFOVMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect == Layout::Aspect::Wider)
     {
-        spdlog::error("Map: MapCursor: Pattern scan failed.");
+        ctx.xmm0.f32[0] = atanf(tanf(ctx.xmm0.f32[0] * (fPi / 360)) * layout.fFOVScale) * (360 / fPi);
     }
+}
 
-    // Map cursor offset
-    uint8_t* MapCursorOffset1ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? 66 0F ?? ?? ?? ?? ?? 00 0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? 0F 57 ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ?? 74 ??") + 0x3;
-    uint8_t* MapCursorOffset2ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? EB ??") + 0x3;
-    uint8_t* MapCursorOffset3ScanResult = Memory::PatternScan(baseModule, "0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 33 ?? 8D ?? ?? ?? ?? 00 8B ??") + 0x3;
-    if (MapCursorOffset1ScanResult && MapCursorOffset2ScanResult && MapCursorOffset3ScanResult)
+// Fix broken depth of field
+// xmm0 is set up before the signature starts, so there is no load to repoint and it stays a hook
+void DOFFixMidHook(LeanHook::Context<Reg::Xmm0>& ctx)
+{
+    DIAGNOSTICS_PROBE("DOFFixMidHook");
+    const auto layout = ResolutionLayout.Load();
+    if (layout.aspect != Layout::Aspect::Native)
     {
-        spdlog::info("Map: MapCursorOffset: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursorOffset1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapCursorOffset: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursorOffset2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapCursorOffset: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapCursorOffset3ScanResult - (uintptr_t)baseModule);
+        ctx.xmm0().f32[0] = (float)720;
+    }
+}
 
-        static SafetyHookMid MapCursorOffset1MidHook1{};
-        MapCursorOffset1MidHook1 = safetyhook::create_mid(MapCursorOffset1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= fHUDWidthOffset;
-                }
-            });
+// Every fix site, in the order the fixes used to be applied
+constexpr Fixes::Site FixRegistry[] = {
+    // HUD Size
+    { "HUD: HUDSize", "HUDSize", 0x0, Feature::HUD, Applies::Wider, HUDWidthConstant },
 
-        static SafetyHookMid MapCursorOffset1MidHook2{};
-        MapCursorOffset1MidHook2 = safetyhook::create_mid(MapCursorOffset1ScanResult + 0x19,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= fHUDHeightOffset;
-                }
-            });
+    // HUD Offset
+    Fixes::Hook<HUDOffsetMidHook>("HUD: HUDOffset", "HUDOffset", 0x0, Feature::HUD, Applies::Wider),
 
-        static SafetyHookMid MapCursorOffset2MidHook1{};
-        MapCursorOffset2MidHook1 = safetyhook::create_mid(MapCursorOffset2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= fHUDWidthOffset;
-                }
-            });
+    Fixes::Hook<HUDBackgrounds1MidHook1>("HUD: HUDBackgrounds", "HUDBackgrounds1", 0x8, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<HUDBackgrounds1MidHook2>("HUD: HUDBackgrounds", "HUDBackgrounds1", 0x1F, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<HUDBackgrounds2MidHook1>("HUD: HUDBackgrounds", "HUDBackgrounds2", 0x8, Feature::HUD, Applies::NotNative),
+    // This one spans certain menu backgrounds but it also spans the capcom logo and maybe more?
+    // Fixes::Hook<HUDBackgrounds2MidHook2>("HUD: HUDBackgrounds", "HUDBackgrounds2", 0x1F, Feature::HUD, Applies::NotNative),
 
-        static SafetyHookMid MapCursorOffset2MidHook2{};
-        MapCursorOffset2MidHook2 = safetyhook::create_mid(MapCursorOffset2ScanResult - 0x13,
-            [](SafetyHookContext& ctx)
+    // Subtitles
+    Fixes::Hook<SubtitlesLayerMidHook>("HUD: SubtitlesLayer", "SubtitlesLayer", 0x0, Feature::HUD, Applies::Wider),
+
+    // Title background
+    { "HUD: TitleBackground", "TitleBackground", 0xF, Feature::HUD, Applies::NotNative, TitleBackgroundConstant },
+
+    // Reported mouse position
+    Fixes::Hook<MousePosXMidHook>("MouseInput: MousePos", "MousePos", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapMousePos1MidHook>("MouseInput: MousePos", "MapMousePos1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapMousePos3MidHook>("MouseInput: MousePos", "MapMousePos3", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapMousePos4MidHook>("MouseInput: MousePos", "MapMousePos4", 0x0, Feature::HUD, Applies::Wider),
+
+    // Mouse position in menus
+    Fixes::Hook<MenuMouse1MidHook1>("MouseInput: MenuMouse", "MenuMouse1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MenuMouse1MidHook2>("MouseInput: MenuMouse", "MenuMouse1", 0x2F, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MenuMouse2MidHook1>("MouseInput: MenuMouse", "MenuMouse2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MenuMouse2MidHook2>("MouseInput: MenuMouse", "MenuMouse2", 0x32, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MenuMouse3MidHook>("MouseInput: MenuMouse", "MenuMouse3", 0x0, Feature::HUD, Applies::Wider),
+
+    Fixes::Hook<Scrollbar1MidHook1>("MouseInput: Scrollbar", "Scrollbar1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar1MidHook2>("MouseInput: Scrollbar", "Scrollbar1", 0x25, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar2MidHook>("MouseInput: Scrollbar", "Scrollbar2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar3MidHook1>("MouseInput: Scrollbar", "Scrollbar3", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar3MidHook2>("MouseInput: Scrollbar", "Scrollbar3", 0x17, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar4MidHook1>("MouseInput: Scrollbar", "Scrollbar4", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<Scrollbar4MidHook2>("MouseInput: Scrollbar", "Scrollbar4", 0x25, Feature::HUD, Applies::Wider),
+
+    // Interaction markers
+    Fixes::Hook<MarkersWidthMidHook>("Markers", "Markers", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MarkersHeightMidHook>("Markers", "Markers", 0x28, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MarkersOffsetMidHook>("Markers", "Markers", 0x30, Feature::HUD, Applies::NotNative),
+
+    // Minimap width multiplier
+    Fixes::Hook<MinimapWidthMultiMidHook>("Minimap: MinimapWidthMulti", "MinimapWidthMulti", 0x0, Feature::HUD, Applies::Wider),
+
+    // Minimap texture size and position
+    Fixes::Hook<MinimapTexture1MidHook>("Minimap: MinimapTexture", "MinimapTexture", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MinimapTexture2MidHook>("Minimap: MinimapTexture", "MinimapTexture", 0x92, Feature::HUD, Applies::Wider), // Big gap, maybe do a second pattern?
+    Fixes::Hook<MinimapTexturePositionMidHook>("Minimap: MinimapTexture", "MinimapTexturePosition", 0x0, Feature::HUD, Applies::Wider),
+
+    // Minimap fog
+    Fixes::Hook<MinimapFog1MidHook>("Minimap: MinimapFog", "MinimapFog1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MinimapFog2MidHook1>("Minimap: MinimapFog", "MinimapFog2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MinimapFog2MidHook2>("Minimap: MinimapFog", "MinimapFog2", 0x21, Feature::HUD, Applies::Wider),
+
+    // Minimap icons height offset
+    Fixes::Hook<MinimapIconHeightOffsetMidHook>("Minimap: MinimapIconHeightOffset", "MinimapIconHeightOffset", 0x0, Feature::HUD, Applies::NotNative),
+
+    // Minimap height offset
+    Fixes::Hook<MinimapHeightOffsetMidHook>("Minimap: MinimapHeightOffset", "MinimapHeightOffset", 0x0, Feature::HUD, Applies::Wider),
+
+    // Minimap width offset
+    Fixes::Hook<MinimapWidthOffset1MidHook>("Minimap: MinimapWidthOffset", "MinimapWidthOffset1", -0x8, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<MinimapWidthOffset2MidHook>("Minimap: MinimapWidthOffset", "MinimapWidthOffset2", 0x0, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<MinimapWidthOffset3MidHook>("Minimap: MinimapWidthOffset", "MinimapWidthOffset3", 0x0, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<MinimapWidthOffset4MidHook>("Minimap: MinimapWidthOffset", "MinimapWidthOffset4", 0x0, Feature::HUD, Applies::NotNative),
+
+    // Map frame
+    Fixes::Hook<MapFrameMidHook>("Map: MapFrame", "MapFrame", 0x11, Feature::HUD, Applies::Wider),
+
+    // Map location menu
+    Fixes::Hook<MapLocationMenuMidHook>("Map: MapLocationMenu", "MapLocationMenu", 0x0, Feature::HUD, Applies::Wider),
+
+    // Map position hor offset
+    Fixes::Hook<MapPosOffsetHorMidHook>("Map: MapPosOffset", "MapPosOffsetHor", 0x0, Feature::HUD, Applies::Wider),
+
+    // Map cursor boundary
+    Fixes::Hook<MapCursor1MidHook>("Map: MapCursor", "MapCursor1", 0x0, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<MapCursor2MidHook>("Map: MapCursor", "MapCursor2", 0x0, Feature::HUD, Applies::NotNative),
+    Fixes::Hook<MapCursor3MidHook>("Map: MapCursor", "MapCursor3", 0x0, Feature::HUD, Applies::NotNative),
+
+    // Map cursor offset
+    Fixes::Hook<MapCursorOffset1MidHook1>("Map: MapCursorOffset", "MapCursorOffset1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapCursorOffset1MidHook2>("Map: MapCursorOffset", "MapCursorOffset1", 0x19, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapCursorOffset2MidHook1>("Map: MapCursorOffset", "MapCursorOffset2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapCursorOffset2MidHook2>("Map: MapCursorOffset", "MapCursorOffset2", -0x13, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapCursorOffset3MidHook1>("Map: MapCursorOffset", "MapCursorOffset3", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapCursorOffset3MidHook2>("Map: MapCursorOffset", "MapCursorOffset3", 0x42, Feature::HUD, Applies::Narrower),
+
+    // Map icons width offset
+    Fixes::Hook<MapIconWidthOffset1MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapIconHeightOffset1MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset1", 0x34, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapIconWidthOffset2MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapIconHeightOffset2MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset2", 0x1F, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapIconWidthOffset3MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset3", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapIconHeightOffset3MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset3", 0x22, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapIconWidthOffset4MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset4", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapIconHeightOffset4MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset4", 0x1B, Feature::HUD, Applies::Narrower),
+    Fixes::Hook<MapIconWidthOffset5MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset5", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapIconHeightOffset5MidHook>("Map: MapIconWidthOffset", "MapIconWidthOffset5", 0x21, Feature::HUD, Applies::Narrower),
+
+    // Map Area
+    Fixes::Hook<MapArea1MidHook1>("Map: MapArea", "MapArea1", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapArea1MidHook2>("Map: MapArea", "MapArea1", 0x3F, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapArea2MidHook1>("Map: MapArea", "MapArea2", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapArea3MidHook1>("Map: MapArea", "MapArea3", 0x0, Feature::HUD, Applies::Wider),
+    Fixes::Hook<MapArea4MidHook1>("Map: MapArea", "MapArea4", 0x0, Feature::HUD, Applies::Wider),
+    // Patch offset to match empty data location, which MapArea5MidHook1 fills in
+    // There's no way to access the FPU registers with SafetyHook (that I know of), hence this somewhat hacky solution.
+    Fixes::Patch<0xB4>("Map: MapArea", "MapArea5", 0x2, Feature::HUD),
+    Fixes::Hook<MapArea5MidHook1>("Map: MapArea", "MapArea5", 0x0, Feature::HUD),
+
+    // FMVs
+    Fixes::Hook<MovieMidHook>("Movie", "Movie", 0x0, Feature::HUD, Applies::NotNative),
+
+    // Aspect ratio
+    Fixes::Hook<AspectRatioMidHook>("FOV: AspectRatio", "AspectRatio", 0x0, Feature::Core, Applies::Narrower),
+
+    // Loading screen aspect ratio
+    Fixes::Hook<LoadingAspectMidHook>("FOV: LoadingAspect", "LoadingAspect", 0x0, Feature::FOV, Applies::Narrower),
+
+    // Cutscene FOV
+    Fixes::Hook<CutsceneFOVMidHook>("FOV: CutsceneFOV", "CutsceneFOV", 0x5, Feature::FOV, Applies::Wider),
+
+    // Fix broken depth of field
+    Fixes::Hook<DOFFixMidHook>("DOFFix", "DOFFix", 0x0, Feature::Core, Applies::NotNative),
+};
+static_assert(Fixes::Valid(FixRegistry), "Fix registry names an unknown or data signature, or splits a fix");
+
+// Where the hand written fixes hooked the sites whose signature has a target, counted from the match
+constexpr Fixes::MatchOffset TargetedSites[] = {
+    { "MousePos", 0x7 },
+    { "Scrollbar1", 0x3 },
+    { "Scrollbar1", 0x28 },
+    { "Scrollbar2", 0x10 },
+    { "Scrollbar4", 0x3 },
+    { "Scrollbar4", 0x28 },
+    { "MinimapWidthMulti", 0xB },
+    { "MinimapTexture", 0x8 },
+    { "MinimapTexture", 0x9A },
+    { "MinimapTexturePosition", 0x3 },
+    { "MinimapHeightOffset", 0x7 },
+    { "MapPosOffsetHor", 0x5 },
+    { "MapCursorOffset1", 0x3 },
+    { "MapCursorOffset1", 0x1C },
+    { "MapCursorOffset2", 0x3 },
+    { "MapCursorOffset2", -0x10 },
+    { "MapCursorOffset3", 0x3 },
+    { "MapCursorOffset3", 0x45 },
+    { "MapArea3", 0xB },
+};
+static_assert(Fixes::SameAddresses(FixRegistry, TargetedSites), "A site offset doesn't match its signature's target");
+
+// Offsets count from the signature's target, so the registry and Target() agree on where a signature points
+// A site's offset is resolved like any other chain, so it can't step outside the module
+Resolve::Address<> SiteAddress(const Fixes::Site& site)
+{
+    return Resolve::Follow(Resolve::Chain().Add(site.offset), Target(site.signature).get(), ModuleImage);
+}
+
+void PrepareFixes()
+{
+    // Prepares every fix whose signatures were all found. Features the ini turns off are prepared as
+    // well and only left disabled, so a config reload can turn them on.
+    auto fixStart = std::begin(FixRegistry);
+    while (fixStart != std::end(FixRegistry))
+    {
+        auto fixEnd = std::find_if(fixStart, std::end(FixRegistry), [&](const Fixes::Site& site) { return std::string_view(site.fix) != fixStart->fix; });
+        auto missing = std::find_if(fixStart, fixEnd, [](const Fixes::Site& site) { return !SiteAddress(site); });
+        if (missing != fixEnd)
+        {
+            spdlog::error("{}: Pattern scan failed for {}.", fixStart->fix, missing->signature);
+            fixStart = fixEnd;
+            continue;
+        }
+
+        for (auto site = fixStart; site != fixEnd; ++site)
+        {
+            uint8_t* address = SiteAddress(*site).get();
+            spdlog::info("{}: {}{:+#x}: Address is {:s}+{:x}", site->fix, site->signature, site->offset, sExeName.c_str(), (uintptr_t)address - (uintptr_t)baseModule);
+
+            auto feature = Hooks.Tag(site->feature);
+            if (!site->install(Hooks, address, site->applies))
             {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm1.f32[0] -= fHUDHeightOffset;
-                }
-            });
+                spdlog::error("{}: Failed to prepare {}{:+#x}.", site->fix, site->signature, site->offset);
+            }
+        }
+        fixStart = fixEnd;
+    }
+}
 
-        static SafetyHookMid MapCursorOffset3MidHook1{};
-        MapCursorOffset3MidHook1 = safetyhook::create_mid(MapCursorOffset3ScanResult,
-            [](SafetyHookContext& ctx)
+void ApplyFramerateCap()
+{
+    // The frame limiter needs the game's own cap out of the way
+    if (VariableFPSAddress)
+    {
+        Memory::Write(VariableFPSAddress, (bUncapFPS || bFrameLimiter) ? (float)1000 : fOriginalVariableFPS);
+    }
+}
+
+void Miscellaneous()
+{
+    // Variable FPS cap, the original value is kept so a config reload can put it back
+    auto VariableFPSValue = Target<float>("FPSCap");
+    if (VariableFPSValue)
+    {
+        spdlog::info("FPSCap: Value address is {:s}+{:x}", sExeName.c_str(), VariableFPSValue.value() - (uintptr_t)baseModule);
+
+        VariableFPSAddress = VariableFPSValue.value();
+        fOriginalVariableFPS = *VariableFPSValue.get();
+        ApplyFramerateCap();
+    }
+    else
+    {
+        spdlog::error("FPSCap: Pattern scan failed.");
+    }
+}
+
+void FrameBoundary()
+{
+    // The frame limiter picks its target frame time here once per frame, which is the closest thing to a present call we scan for
+    uint8_t* FrameBoundaryScanResult = Signatures.Get("FPSCap");
+    if (!FrameBoundaryScanResult)
+    {
+        spdlog::error("Frame Boundary: Pattern scan failed.");
+        return;
+    }
+    spdlog::info("Frame Boundary: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)FrameBoundaryScanResult - (uintptr_t)baseModule);
+
+    // A config reload only publishes a new target, the limiter itself is only touched from the hook
+    static Limiter::FrameLimiter FrameLimiter(0.0);
+    static float fActiveFrameLimit = 0.0f;
+    fFrameLimitTarget = bFrameLimiter ? fFrameLimit : 0.0f;
+    if (bFrameLimiter)
+    {
+        spdlog::info("Frame Limiter: Limiting to {}fps.", fFrameLimit);
+    }
+
+    auto feature = Hooks.Tag(Feature::FramePacing);
+    static SafetyHookMid FrameBoundaryMidHook{};
+    Hooks.Create(FrameBoundaryMidHook, FrameBoundaryScanResult,
+        [](SafetyHookContext& ctx)
+        {
+            // Limit first so captured frame times show the paced result
+            float fTarget = fFrameLimitTarget.load(std::memory_order_relaxed);
+            if (fTarget != fActiveFrameLimit)
             {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] -= fHUDWidthOffset;
-                }
-            });
+                FrameLimiter.SetTargetFps(fTarget);
+                fActiveFrameLimit = fTarget;
+            }
+            FrameLimiter.Wait();
+            if (bFrameTimeCapture)
+            {
+                LARGE_INTEGER now;
+                QueryPerformanceCounter(&now);
+                FrameRecorder.Push(now.QuadPart);
+            }
+        });
+}
 
-        static SafetyHookMid MapCursorOffset3MidHook2{};
-        MapCursorOffset3MidHook2 = safetyhook::create_mid(MapCursorOffset3ScanResult + 0x42,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= fHUDHeightOffset;
-                }
-            });
-    }
-    else if (!MapCursorOffset1ScanResult || !MapCursorOffset2ScanResult || !MapCursorOffset3ScanResult)
+void FrameTimeCapture()
+{
+    if (!bFrameTimeCapture || !Signatures.Get("FPSCap"))
     {
-        spdlog::error("Map: MapCursorOffset: Pattern scan failed.");
+        return;
     }
 
-    // Map icons width offset
-    uint8_t* MapIconWidthOffset1ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? 51 F3 0F ?? ?? F3 0F ?? ?? 8B ??");
-    uint8_t* MapIconWidthOffset2ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? 8D ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 52 8B ??");
-    uint8_t* MapIconWidthOffset3ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 51 8B ?? ?? ??");
-    uint8_t* MapIconWidthOffset4ScanResult = Memory::PatternScan(baseModule, "51 8B ?? F3 0F ?? ?? ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 51 8B ??");
-    uint8_t* MapIconWidthOffset5ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ??");
-    if (MapIconWidthOffset1ScanResult && MapIconWidthOffset2ScanResult && MapIconWidthOffset3ScanResult && MapIconWidthOffset4ScanResult && MapIconWidthOffset5ScanResult)
-    {
-        spdlog::info("Map: MapIconWidthOffset: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapIconWidthOffset1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapIconWidthOffset: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapIconWidthOffset2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapIconWidthOffset: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapIconWidthOffset3ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapIconWidthOffset: 4: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapIconWidthOffset4ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapIconWidthOffset: 5: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapIconWidthOffset5ScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid MapIconWidthOffset1MidHook{};
-        MapIconWidthOffset1MidHook = safetyhook::create_mid(MapIconWidthOffset1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
-                }
-            });
+    // Statistics and CSV export run on their own thread, the hook only stores a timestamp
+    std::thread([]()
+        {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
 
-        static SafetyHookMid MapIconHeightOffset1MidHook{};
-        MapIconHeightOffset1MidHook = safetyhook::create_mid(MapIconWidthOffset1ScanResult + 0x34,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
-                }
-            });
+            std::vector<int64_t> window;
+            std::vector<int64_t> run;
+            std::vector<int64_t> pending;
+            uint64_t lost = 0;
+            bool bRecording = false;
+            bool bKeyWasDown = false;
 
-        static SafetyHookMid MapIconWidthOffset2MidHook{};
-        MapIconWidthOffset2MidHook = safetyhook::create_mid(MapIconWidthOffset2ScanResult,
-            [](SafetyHookContext& ctx)
+            auto writeRun = [&]()
             {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm2.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
-                }
-            });
+                auto frameTimes = FrameTime::FrameTimes(run, frequency.QuadPart);
+                time_t now = time(nullptr);
+                tm local{};
+                localtime_s(&local, &now);
+                char fileName[64];
+                strftime(fileName, sizeof(fileName), "DDDAFix_FrameTimes_%Y%m%d_%H%M%S.csv", &local);
 
-        static SafetyHookMid MapIconHeightOffset2MidHook{};
-        MapIconHeightOffset2MidHook = safetyhook::create_mid(MapIconWidthOffset2ScanResult + 0x1F,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
+                if (FrameTime::WriteCsv(sThisModulePath / fileName, frameTimes))
                 {
-                    ctx.xmm0.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
+                    spdlog::info("Frame Time: Wrote {} frames to {}.", frameTimes.size(), fileName);
                 }
-            });
-
-        static SafetyHookMid MapIconWidthOffset3MidHook{};
-        MapIconWidthOffset3MidHook = safetyhook::create_mid(MapIconWidthOffset3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
+                else
                 {
-                    ctx.xmm0.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
+                    spdlog::error("Frame Time: Failed to write {}.", fileName);
                 }
-            });
+            };
 
-        static SafetyHookMid MapIconHeightOffset3MidHook{};
-        MapIconHeightOffset3MidHook = safetyhook::create_mid(MapIconWidthOffset3ScanResult + 0x22,
-            [](SafetyHookContext& ctx)
+            auto interval = std::chrono::seconds((std::max)(iFrameTimeReportInterval, 1));
+            auto nextReport = std::chrono::steady_clock::now() + interval;
+            while (WaitForSingleObject(hWindowClosed, 100) == WAIT_TIMEOUT)
             {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
-                }
-            });
 
-        static SafetyHookMid MapIconWidthOffset4MidHook{};
-        MapIconWidthOffset4MidHook = safetyhook::create_mid(MapIconWidthOffset4ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
+                pending.clear();
+                lost += FrameRecorder.Drain(pending);
+                window.insert(window.end(), pending.begin(), pending.end());
+                if (bRecording)
                 {
-                    ctx.xmm2.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
+                    run.insert(run.end(), pending.begin(), pending.end());
                 }
-            });
 
-
-        static SafetyHookMid MapIconHeightOffset4MidHook{};
-        MapIconHeightOffset4MidHook = safetyhook::create_mid(MapIconWidthOffset4ScanResult + 0x1B,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio < fNativeAspect)
+                bool bKeyDown = (GetAsyncKeyState(iCaptureHotkey) & 0x8000) && GetForegroundWindow() == hWnd;
+                if (bKeyDown && !bKeyWasDown)
                 {
-                    ctx.xmm0.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
+                    bRecording = !bRecording;
+                    if (bRecording)
+                    {
+                        // Start from the last frame seen so the first frame time is complete
+                        run.assign(window.end() - (std::min)(window.size(), size_t(1)), window.end());
+                        spdlog::info("Frame Time: Capture started.");
+                    }
+                    else
+                    {
+                        writeRun();
+                    }
                 }
-            });
+                bKeyWasDown = bKeyDown;
 
-        static SafetyHookMid MapIconWidthOffset5MidHook{};
-        MapIconWidthOffset5MidHook = safetyhook::create_mid(MapIconWidthOffset5ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
+                if (std::chrono::steady_clock::now() >= nextReport)
                 {
-                    ctx.xmm1.f32[0] -= (float)((720 * fAspectRatio) - 1280) / 2;
+                    auto stats = FrameTime::Analyse(FrameTime::FrameTimes(window, frequency.QuadPart), fStutterThreshold);
+                    spdlog::info("Frame Time: {} frames, avg {:.2f}ms ({:.1f}fps), p50 {:.2f}ms, p99 {:.2f}ms, p99.9 {:.2f}ms, max {:.2f}ms, 1% low {:.1f}fps, 0.1% low {:.1f}fps, {} stutters, {} lost",
+                        stats.frames, stats.averageMs, stats.averageFps, stats.p50Ms, stats.p99Ms, stats.p999Ms, stats.maxMs, stats.low1Fps, stats.low01Fps, stats.stutters, lost);
+
+                    // Keep the last timestamp so the next window starts with a full frame
+                    window.erase(window.begin(), window.end() - (std::min)(window.size(), size_t(1)));
+                    lost = 0;
+                    nextReport += interval;
                 }
-            });
+            }
 
-        static SafetyHookMid MapIconHeightOffset5MidHook{};
-        MapIconHeightOffset5MidHook = safetyhook::create_mid(MapIconWidthOffset5ScanResult + 0x21,
-            [](SafetyHookContext& ctx)
+            if (bRecording)
             {
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] -= (float)((1280 / fAspectRatio) - 720) / 2;
-                }
-            });
-    }
-    else if (!MapIconWidthOffset1ScanResult || !MapIconWidthOffset2ScanResult || !MapIconWidthOffset3ScanResult || !MapIconWidthOffset4ScanResult || !MapIconWidthOffset5ScanResult)
+                writeRun();
+            }
+        }).detach();
+}
+
+void ApplyBorderless()
+{
+    if (!hWnd)
     {
-        spdlog::error("Map: MapIconWidthOffset: Pattern scan failed.");
+        return;
     }
 
-    // Map Area
-    uint8_t* MapArea1ScanResult = Memory::PatternScan(baseModule, "C1 ?? 02 2B ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? D1 F8");
-    uint8_t* MapArea2ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F ?? ?? 84 ?? 74 ?? 66 0F ?? ?? ?? ?? ?? 00 0F 28 ??");
-    uint8_t* MapArea3ScanResult = Memory::PatternScan(baseModule, "0F 5B ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? F3 0F ?? ?? ?? ?? ?? 00") + 0xB;
-    uint8_t* MapArea4ScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? 8B ?? ?? 8B ?? ?? 89 ?? ?? ?? 89 ?? ?? ?? 74 ??");
-    uint8_t* MapArea5ScanResult = Memory::PatternScan(baseModule, "DB ?? ?? ?? ?? 00 D8 ?? ?? ?? ?? ?? D9 ?? ?? D8 ?? ?? ?? ?? ??");
-    if (MapArea1ScanResult)
-    {
-        spdlog::info("Map: MapArea: 1: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapArea1ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapArea: 2: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapArea2ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapArea: 3: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapArea3ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapArea: 4: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapArea4ScanResult - (uintptr_t)baseModule);
-        spdlog::info("Map: MapArea: 5: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MapArea5ScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid MapArea1MidHook1{};
-        MapArea1MidHook1 = safetyhook::create_mid(MapArea1ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)fHUDWidth * fDefMinimapMulti;
-                }
-            });
+    LONG lStyle = GetWindowLong(hWnd, GWL_STYLE);
+    if (bBorderlessWindowed && iFullscreenMode == 0 && (lStyle & WS_POPUP) != WS_POPUP)
+    {
+        lStyle &= ~(WS_POPUP | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX);
+        SetWindowLong(hWnd, GWL_STYLE, lStyle);
 
-        static SafetyHookMid MapArea1MidHook2{};
-        MapArea1MidHook2 = safetyhook::create_mid(MapArea1ScanResult + 0x3F,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm3.f32[0] = (float)fHUDWidth * fDefMinimapMulti;
-                }
-            });
+        GetWindowRect(GetDesktopWindow(), &rcDesktop);
+        SetWindowPos(hWnd, HWND_TOP, 0, 0, rcDesktop.right, rcDesktop.bottom, NULL);
+    }
+}
 
-        static SafetyHookMid MapArea2MidHook1{};
-        MapArea2MidHook1 = safetyhook::create_mid(MapArea2ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)fHUDWidth * fDefMinimapMulti;
-                }
-            });
+bool IsGameWindow(HWND window)
+{
+    WCHAR className[256];
+    return GetClassNameW(window, className, 256) && wcscmp(className, sWindowClassName) == 0;
+}
 
-        static SafetyHookMid MapArea3MidHook1{};
-        MapArea3MidHook1 = safetyhook::create_mid(MapArea3ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)fHUDWidth * fDefMinimapMulti;
-                }
-            });
+void AttachWindow(HWND window)
+{
+    // A window can be reported by both the initial FindWindowW and its create event, never subclass it twice
+    if ((WNDPROC)GetWindowLongPtr(window, GWLP_WNDPROC) == NewWndProc)
+    {
+        return;
+    }
 
-        static SafetyHookMid MapArea4MidHook1{};
-        MapArea4MidHook1 = safetyhook::create_mid(MapArea4ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    ctx.xmm6.f32[0] = fDefMinimapMulti / fAspectMultiplier;
-                }
-            });
+    hWnd = window;
+    spdlog::info("Window Focus: Found {}window handle.", bWindowSeen ? "recreated " : "");
+    bWindowSeen = true;
 
-        // Patch offset to match empty data location
-        // There's no way to access the FPU registers with SafetyHook (that I know of), hence this somewhat hacky solution.
-        Memory::PatchBytes((uintptr_t)MapArea5ScanResult + 0x2, "\xB4", 1);
+    // Get window mode and apply borderless styles
+    static bool bWindowModeHooked = false;
+    if (!bWindowModeHooked)
+    {
+        bWindowModeHooked = true;
+        uint8_t* WindowModeScanResult = Signatures.Get("WindowMode");
+        if (WindowModeScanResult)
+        {
+            spdlog::info("WindowMode: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)WindowModeScanResult - (uintptr_t)baseModule);
 
-        static SafetyHookMid MapArea5MidHook1{};
-        MapArea5MidHook1 = safetyhook::create_mid(MapArea5ScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                if (fAspectRatio > fNativeAspect)
-                {
-                    if (ctx.eax + 0xB4)
-                    {
-                        // Insert fHUDWidth into empty space
-                        *reinterpret_cast<int*>(ctx.eax + 0xB4) = (int)fHUDWidth;
-                    }
-                }
-                else if (fAspectRatio <= fNativeAspect)
+            static SafetyHookMid WindowModeMidHook{};
+            WindowModeMidHook = safetyhook::create_mid(WindowModeScanResult,
+                [](SafetyHookContext& ctx)
                 {
-                    if (ctx.eax + 0xB4)
+                    DIAGNOSTICS_PROBE("WindowModeMidHook");
+                    if (ctx.edi + 0x23)
                     {
-                        // Insert iResX into empty space
-                        *reinterpret_cast<int*>(ctx.eax + 0xB4) = iResX;
+                        iFullscreenMode = *reinterpret_cast<BYTE*>(ctx.edi + 0x23);
+                        bWindowModeKnown = true;
+                        ApplyBorderless();
                     }
-                }
-            });
+                });
+        }
+        else if (!WindowModeScanResult)
+        {
+            spdlog::error("WindowMode: Pattern scan failed.");
+        }
     }
-    else if (!MapArea1ScanResult || !MapArea2ScanResult || !MapArea3ScanResult || !MapArea4ScanResult || !MapArea5ScanResult)
+    else if (bWindowModeKnown)
     {
-        spdlog::error("Map: MapArea: Pattern scan failed.");
+        // Recreated window, the game has already told us which mode it is in
+        ApplyBorderless();
     }
-   
+
+    // Set new wnd proc
+    OldWndProc = (WNDPROC)SetWindowLongPtr(hWnd, GWLP_WNDPROC, (LONG_PTR)NewWndProc);
+    spdlog::info("Window Focus: Set new WndProc.");
 }
 
-void Movie()
+void CALLBACK WindowEventProc(HWINEVENTHOOK hook, DWORD event, HWND window, LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime)
 {
-    // FMVs
-    uint8_t* MovieScanResult = Memory::PatternScan(baseModule, "8B ?? ?? ?? 89 ?? ?? 89 ?? ?? 8B ?? E8 ?? ?? ?? ?? 8B ?? E8 ?? ?? ?? ?? 5E");
-    if (MovieScanResult)
+    if (!window || idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
     {
-        spdlog::info("Movie: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)MovieScanResult - (uintptr_t)baseModule);
+        return;
+    }
 
-        static SafetyHookMid MovieMidHook{};
-        MovieMidHook = safetyhook::create_mid(MovieScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                    if (ctx.eax)
-                    {
-                        if (fAspectRatio > fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.eax) = (float)-1 / fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x10) = (float)-1 / fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x20) = (float)1 / fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x30) = (float)1 / fAspectMultiplier;
-                        }
-                        else if (fAspectRatio < fNativeAspect)
-                        {
-                            *reinterpret_cast<float*>(ctx.eax + 0x04) = (float)1 * fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x14) = (float)-1 * fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x24) = (float)1 * fAspectMultiplier;
-                            *reinterpret_cast<float*>(ctx.eax + 0x34) = (float)-1 * fAspectMultiplier;
-                        }
-                    }
-            });
+    if (event == EVENT_OBJECT_CREATE && window != hWnd && IsGameWindow(window))
+    {
+        AttachWindow(window);
     }
-    else if (!MovieScanResult)
+    else if (event == EVENT_OBJECT_DESTROY && window == hWnd)
     {
-        spdlog::error("Movie: Pattern scan failed.");
+        spdlog::info("Window Focus: Window destroyed, waiting for it to be recreated.");
+        hWnd = nullptr;
+        iWindowLostTick = GetTickCount64();
     }
 }
 
-void AspectFOV()
+DWORD __stdcall WindowWatcher(void*)
 {
-    // Aspect ratio
-    uint8_t* AspectRatioScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00");
-    if (AspectRatioScanResult)
+    // Out of context events are delivered through this thread's message queue
+    HWINEVENTHOOK eventHook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_DESTROY, nullptr, WindowEventProc, GetCurrentProcessId(), 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNTHREAD);
+    if (!eventHook)
     {
-        spdlog::info("FOV: AspectRatio: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)AspectRatioScanResult - (uintptr_t)baseModule);
-
-        static SafetyHookMid AspectRatioMidHook{};
-        AspectRatioMidHook = safetyhook::create_mid(AspectRatioScanResult,
-            [](SafetyHookContext& ctx)
-            {
-                // Only needed at <16:9
-                if (fAspectRatio < fNativeAspect)
-                {
-                    ctx.xmm0.f32[0] = (float)iResY / iResX;
-                }
-            });
+        spdlog::error("Window Focus: Failed to install window event hook.");
+        SetEvent(hWindowClosed);
+        return false;
     }
-    else if (!AspectRatioScanResult)
+
+    // The window may have been created before the hook was installed
+    HWND window = FindWindowW(sWindowClassName, nullptr);
+    if (window)
     {
-        spdlog::error("FOV: AspectRatio: Pattern scan failed.");
+        AttachWindow(window);
     }
 
-    if (bFixFOV)
+    // Give the game 30 seconds to create its window and 5 seconds to recreate it
+    ULONGLONG iStartTick = GetTickCount64();
+    for (;;)
     {
-        /*
-        // Gameplay FOV
-        uint8_t* GameplayFOVScanResult = Memory::PatternScan(baseModule, "F3 0F 59 ?? ?? ?? ?? 00 E8 ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? 8B ?? ??");
-        if (GameplayFOVScanResult)
-        {
-            spdlog::info("AspectFOV: GameplayFOV: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)GameplayFOVScanResult - (uintptr_t)baseModule);
-
-            static SafetyHookMid GameplayFOVMidHook{};
-            GameplayFOVMidHook = safetyhook::create_mid(GameplayFOVScanResult,
-                [](SafetyHookContext& ctx)
-                {
-                });
-        }
-        else if (!GameplayFOVScanResult)
+        DWORD timeout = INFINITE;
+        if (!hWnd)
         {
-            spdlog::error("AspectFOV: GameplayFOV: Pattern scan failed.");
+            ULONGLONG deadline = bWindowSeen ? iWindowLostTick + 5000 : iStartTick + 30000;
+            ULONGLONG now = GetTickCount64();
+            timeout = now < deadline ? (DWORD)(deadline - now) : 0;
         }
-        */
-
-        // Loading screen aspect ratio
-        uint8_t* LoadingAspectScanResult = Memory::PatternScan(baseModule, "F3 0F 11 ?? ?? ?? EB ?? 8B ?? ?? 0F ?? ?? C1 ?? 10 89 ?? ?? ??");
-        if (LoadingAspectScanResult)
-        {
-            spdlog::info("AspectFOV: LoadingAspect: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)LoadingAspectScanResult - (uintptr_t)baseModule);
 
-            static SafetyHookMid LoadingAspectMidHook{};
-            LoadingAspectMidHook = safetyhook::create_mid(LoadingAspectScanResult,
-                [](SafetyHookContext& ctx)
-                {
-                    if (fAspectRatio < fNativeAspect)
-                    {
-                        ctx.xmm0.f32[0] = fNativeAspect;
-                    }
-                });
-        }
-        else if (!LoadingAspectScanResult)
+        if (MsgWaitForMultipleObjects(0, nullptr, FALSE, timeout, QS_ALLINPUT) == WAIT_TIMEOUT && !hWnd)
         {
-            spdlog::error("AspectFOV: LoadingAspect: Pattern scan failed.");
+            if (bWindowSeen)
+            {
+                spdlog::info("Window Focus: Window closed.");
+            }
+            else
+            {
+                spdlog::error("Window Focus: Failed to find window handle.");
+            }
+            break;
         }
 
-        // Cutscene FOV
-        uint8_t* CutsceneFOVScanResult = Memory::PatternScan(baseModule, "76 ?? 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 8B ?? ?? ?? 83 ?? ??");
-        if (CutsceneFOVScanResult)
-        {
-            spdlog::info("AspectFOV: CutsceneFOV: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)CutsceneFOVScanResult - (uintptr_t)baseModule);
-
-            static SafetyHookMid CutsceneFOVMidHook{};
-            CutsceneFOVMidHook = safetyhook::create_mid(CutsceneFOVScanResult + 0x5,
-                [](SafetyHookContext& ctx)
-                {
-                    if (fAspectRatio > fNativeAspect)
-                    {
-                        ctx.xmm0.f32[0] = atanf(tanf(ctx.xmm0.f32[0] * (fPi / 360)) / fNativeAspect * fAspectRatio) * (360 / fPi);
-                    }
-                });
-        }
-        else if (!CutsceneFOVScanResult)
+        MSG msg;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
         {
-            spdlog::error("AspectFOV: CutsceneFOV: Pattern scan failed.");
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
         }
     }
+
+    UnhookWinEvent(eventHook);
+    SetEvent(hWindowClosed);
+    return true;
 }
 
-void Miscellaneous()
+void AspectGroups()
 {
-    // Fix broken depth of field
-    uint8_t* DOFFixScanResult = Memory::PatternScan(baseModule, "F3 0F ?? ?? ?? ?? ?? ?? 0F ?? ?? 0F ?? ?? 56 57 8B ??");
-    if (DOFFixScanResult)
+    // Hooks that do nothing at the current aspect ratio stay disabled. The resolution hook only signals
+    // the change, the switch happens on this thread since freezing the game from one of its own threads
+    // could deadlock on a lock held by a suspended one.
+    hAspectChanged = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!hAspectChanged)
     {
-        spdlog::info("DOFFix: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)DOFFixScanResult - (uintptr_t)baseModule);
+        spdlog::error("Hooks: Failed to create aspect change event, all hooks stay enabled.");
+        return;
+    }
+    Hooks.UseAspectGroups();
 
-        static SafetyHookMid DOFFixMidHook{};
-        DOFFixMidHook = safetyhook::create_mid(DOFFixScanResult,
-            [](SafetyHookContext& ctx)
+    std::thread([]()
+        {
+            while (WaitForSingleObject(hAspectChanged, INFINITE) == WAIT_OBJECT_0)
             {
-                if (fAspectRatio != fNativeAspect)
+                auto transitionStart = std::chrono::steady_clock::now();
+                auto transition = Hooks.SetAspect(ResolutionLayout.Load().aspect);
+                auto transitionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - transitionStart);
+
+                if (!transition)
                 {
-                    ctx.xmm0.f32[0] = (float)720;
+                    spdlog::error("Hooks: Failed to switch hooks for the new aspect ratio, keeping the previous set.");
                 }
-            });
+                else if (transition->enabled || transition->disabled)
+                {
+                    spdlog::info("Hooks: Aspect ratio class changed, enabled {} and disabled {} hooks in {}us.", transition->enabled, transition->disabled, transitionTime.count());
+                }
+            }
+        }).detach();
+}
+
+std::uint32_t EnabledFeatures()
+{
+    // Frame time capture shares the frame boundary hook but can't be switched at runtime
+    std::uint32_t features = Bit(Feature::Core);
+    features |= bFixHUD ? Bit(Feature::HUD) : 0;
+    features |= bFixFOV ? Bit(Feature::FOV) : 0;
+    features |= (bFrameLimiter || bFrameTimeCapture) ? Bit(Feature::FramePacing) : 0;
+    return features;
+}
+
+void InstallHooks()
+{
+    // Every hook above was only prepared, enable the ones the ini asks for while the game is frozen once
+    Hooks.SetFeatures(EnabledFeatures());
+    auto pending = Hooks.Pending();
+    auto installStart = std::chrono::steady_clock::now();
+    auto enabled = Hooks.Commit();
+    auto installTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - installStart);
+
+    if (!enabled)
+    {
+        spdlog::error("Hooks: Failed to enable a hook, rolled back all {} hooks.", pending);
+    }
+    else
+    {
+        spdlog::info("Hooks: Enabled {} of {} hooks under one thread freeze in {}us.", *enabled, pending, installTime.count());
+    }
+}
+
+void WindowFocus()
+{
+    // Signalled once the game window is gone for good, background loops wait on it
+    hWindowClosed = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    HANDLE watcherHandle = CreateThread(NULL, 0, WindowWatcher, 0, NULL, 0);
+    if (watcherHandle)
+    {
+        CloseHandle(watcherHandle);
+    }
+    else
+    {
+        spdlog::error("Window Focus: Failed to create window watcher thread.");
+        SetEvent(hWindowClosed);
+    }
+}
+
+void ReloadConfig()
+{
+    std::ifstream iniFile(sThisModulePath.string() + sConfigFile);
+    if (!iniFile)
+    {
+        spdlog::warn("Config Reload: Could not open {}, keeping the current settings.", sConfigFile);
+        return;
     }
-    else if (!DOFFixScanResult)
+    inipp::Ini<char> reloadedIni;
+    reloadedIni.parse(iniFile);
+
+    // Values missing from the file go back to their defaults, the same as a fresh start
+    bool bNewUncapFPS = false;
+    bool bNewFrameLimiter = false;
+    float fNewFrameLimit = fDefaultFrameLimit;
+    bool bNewFixHUD = false;
+    bool bNewFixFOV = false;
+    inipp::get_value(reloadedIni.sections["Raise Framerate Cap"], "Enabled", bNewUncapFPS);
+    inipp::get_value(reloadedIni.sections["Frame Limiter"], "Enabled", bNewFrameLimiter);
+    inipp::get_value(reloadedIni.sections["Frame Limiter"], "Framerate", fNewFrameLimit);
+    inipp::get_value(reloadedIni.sections["Fix HUD"], "Enabled", bNewFixHUD);
+    inipp::get_value(reloadedIni.sections["Fix FOV"], "Enabled", bNewFixFOV);
+    if (bNewFrameLimiter && fNewFrameLimit <= 0)
     {
-        spdlog::error("DOFFix: Pattern scan failed.");
+        spdlog::warn("Config Reload: Frame limiter framerate must be above 0, disabling frame limiter.");
+        bNewFrameLimiter = false;
     }
 
-    if (bUncapFPS)
+    // Everything else is only read at startup, including sections that were removed
+    auto reloadable = [](const std::string& name) { return name == "Raise Framerate Cap" || name == "Frame Limiter" || name == "Fix HUD" || name == "Fix FOV"; };
+    for (const auto& [name, section] : reloadedIni.sections)
+    {
+        if (!reloadable(name) && ini.sections[name] != section)
+        {
+            spdlog::warn("Config Reload: Changes to [{}] apply after restarting the game.", name);
+        }
+    }
+    for (const auto& [name, section] : ini.sections)
     {
-        // Variable FPS cap
-        uint8_t* FPSCapScanResult = Memory::PatternScan(baseModule, "8B ?? ?? 83 ?? 00 74 ?? 48 74 ?? 48 75 ?? F3 0F ?? ?? ?? ?? ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? ??") + 0xE;
-        if (FPSCapScanResult)
+        if (!reloadable(name) && !section.empty() && !reloadedIni.sections.contains(name))
         {
-            spdlog::info("FPSCap: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)FPSCapScanResult - (uintptr_t)baseModule);
-            DWORD VariableFPSValue = Memory::GetAbsolute32((uintptr_t)FPSCapScanResult + 0x4);
-            spdlog::info("FPSCap: Value address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)VariableFPSValue - (uintptr_t)baseModule);
+            spdlog::warn("Config Reload: Changes to [{}] apply after restarting the game.", name);
+        }
+    }
 
-            if (VariableFPSValue)
-            {
-                Memory::Write((uintptr_t)VariableFPSValue, (float)1000);
-            }
+    bool bFeaturesChanged = bNewFixHUD != bFixHUD || bNewFixFOV != bFixFOV || bNewFrameLimiter != bFrameLimiter;
+    bool bCapChanged = bNewUncapFPS != bUncapFPS || bNewFrameLimiter != bFrameLimiter;
+    bool bLimitChanged = bNewFrameLimiter != bFrameLimiter || fNewFrameLimit != fFrameLimit;
+    ini = std::move(reloadedIni);
+    if (!bFeaturesChanged && !bCapChanged && !bLimitChanged)
+    {
+        return;
+    }
+
+    spdlog::info("Config Reload: bUncapFPS: {} -> {}", bUncapFPS, bNewUncapFPS);
+    spdlog::info("Config Reload: bFrameLimiter: {} -> {}", bFrameLimiter, bNewFrameLimiter);
+    spdlog::info("Config Reload: fFrameLimit: {} -> {}", fFrameLimit, fNewFrameLimit);
+    spdlog::info("Config Reload: bFixHUD: {} -> {}", bFixHUD, bNewFixHUD);
+    spdlog::info("Config Reload: bFixFOV: {} -> {}", bFixFOV, bNewFixFOV);
+
+    if (bFeaturesChanged)
+    {
+        bool bOldFixHUD = std::exchange(bFixHUD, bNewFixHUD);
+        bool bOldFixFOV = std::exchange(bFixFOV, bNewFixFOV);
+        bool bOldFrameLimiter = std::exchange(bFrameLimiter, bNewFrameLimiter);
+
+        auto transitionStart = std::chrono::steady_clock::now();
+        auto transition = Hooks.SetFeatures(EnabledFeatures());
+        auto transitionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - transitionStart);
+        if (!transition)
+        {
+            spdlog::error("Config Reload: Failed to switch hooks, keeping the previous HUD, FOV and frame limiter settings.");
+            bFixHUD = bOldFixHUD;
+            bFixFOV = bOldFixFOV;
+            bFrameLimiter = bOldFrameLimiter;
         }
-        else if (!FPSCapScanResult)
+        else
         {
-            spdlog::error("FPSCap: Pattern scan failed.");
+            spdlog::info("Config Reload: Enabled {} and disabled {} hooks in {}us.", transition->enabled, transition->disabled, transitionTime.count());
         }
     }
+
+    bUncapFPS = bNewUncapFPS;
+    fFrameLimit = fNewFrameLimit;
+    fFrameLimitTarget = bFrameLimiter ? fFrameLimit : 0.0f;
+    ApplyFramerateCap();
 }
 
-void WindowFocus()
+void ConfigWatcher()
 {
-    int i = 0;
-    while (i < 30 && !IsWindow(hWnd))
+    if (!bHotReload)
     {
-        // Wait 1 sec then try again
-        Sleep(1000);
-        i++;
-        hWnd = FindWindowW(sWindowClassName, nullptr);
+        return;
     }
 
-    // If 30 seconds have passed and we still dont have the handle, give up
-    if (i == 30)
+    // Watch the folder rather than the file, editors often save by replacing it
+    HANDLE hConfigChanged = FindFirstChangeNotificationW(sThisModulePath.wstring().c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    if (hConfigChanged == INVALID_HANDLE_VALUE)
     {
-        spdlog::error("Window Focus: Failed to find window handle.");
+        spdlog::error("Config Reload: Failed to watch {} for changes.", sConfigFile);
         return;
     }
-    else
-    {
-        // Get window mode and apply borderless styles
-        uint8_t* WindowModeScanResult = Memory::PatternScan(baseModule, "80 ?? ?? 00 74 ?? 8B ?? ?? 8B ?? ?? ?? ?? 00 3B ?? ?? ?? ?? 00");
-        if (WindowModeScanResult)
+    spdlog::info("Config Reload: Watching {} for changes.", sConfigFile);
+
+    std::thread([hConfigChanged]()
         {
-            spdlog::info("WindowMode: Address is {:s}+{:x}", sExeName.c_str(), (uintptr_t)WindowModeScanResult - (uintptr_t)baseModule);
+            auto configPath = sThisModulePath / sConfigFile;
+            std::error_code error;
+            auto lastWrite = std::filesystem::last_write_time(configPath, error);
 
-            static SafetyHookMid WindowModeMidHook{};
-            WindowModeMidHook = safetyhook::create_mid(WindowModeScanResult,
-                [](SafetyHookContext& ctx)
+            HANDLE handles[] = { hConfigChanged, hWindowClosed };
+            while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0)
+            {
+                // Let the editor finish writing, then only react when the ini itself changed since the
+                // log and cache files next to it are written all the time
+                Sleep(200);
+                FindNextChangeNotification(hConfigChanged);
+
+                auto writeTime = std::filesystem::last_write_time(configPath, error);
+                if (error || writeTime == lastWrite)
                 {
-                    if (ctx.edi + 0x23)
-                    {
-                        iFullscreenMode = *reinterpret_cast<BYTE*>(ctx.edi + 0x23);
+                    continue;
+                }
+                lastWrite = writeTime;
+                ReloadConfig();
+            }
+            FindCloseChangeNotification(hConfigChanged);
+        }).detach();
+}
 
-                        LONG lStyle = GetWindowLong(hWnd, GWL_STYLE);
-                        if (bBorderlessWindowed && iFullscreenMode == 0 && (lStyle & WS_POPUP) != WS_POPUP)
-                        {
-                            lStyle &= ~(WS_POPUP | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX);
-                            SetWindowLong(hWnd, GWL_STYLE, lStyle);
+void DiagnosticsReport()
+{
+    if (!bDiagnostics)
+    {
+        return;
+    }
 
-                            GetWindowRect(GetDesktopWindow(), &rcDesktop);
-                            SetWindowPos(hWnd, HWND_TOP, 0, 0, rcDesktop.right, rcDesktop.bottom, NULL);
-                        }
-                    }
-                });
+#if defined(DDDAFIX_DIAGNOSTICS)
+    auto dumpSummary = [](const char* reason)
+    {
+        spdlog::info("----------");
+        spdlog::info("Diagnostics: {} hook summary", reason);
+        for (const auto& line : Diagnostics::Summaries())
+        {
+            spdlog::info("Diagnostics: {}", line);
         }
-        else if (!WindowModeScanResult)
+        spdlog::info("----------");
+    };
+
+    // Keep the Main thread around to report until the game window goes away
+    auto interval = std::chrono::seconds((std::max)(iDiagnosticsInterval, 1));
+    auto nextDump = std::chrono::steady_clock::now() + interval;
+    while (WaitForSingleObject(hWindowClosed, 250) == WAIT_TIMEOUT)
+    {
+        if (std::chrono::steady_clock::now() >= nextDump)
         {
-            spdlog::error("WindowMode: Pattern scan failed.");
+            dumpSummary("Periodic");
+            nextDump += interval;
         }
-        // Set new wnd proc
-        OldWndProc = (WNDPROC)SetWindowLongPtr(hWnd, GWLP_WNDPROC, (LONG_PTR)NewWndProc);
-        spdlog::info("Window Focus: Set new WndProc.");
     }
+
+    dumpSummary("Shutdown");
+    spdlog::default_logger()->flush();
+#else
+    spdlog::warn("Diagnostics: Enabled in config but this build was compiled without DDDAFIX_DIAGNOSTICS.");
+#endif
 }
 
 DWORD __stdcall Main(void*)
 {
     Logging();
     ReadConfig();
-    Sleep(iInjectionDelay);
+    ScanSignatures();
+    HookArena();
     GetResolution();
-    if (bFixHUD)
-    {
-        HUD();
-        MouseInput();
-        Markers();
-        Minimap();
-        Map();
-        Movie();
-    }
-    AspectFOV();
+    PrepareFixes();
     Miscellaneous();
+    FrameBoundary();
+    AspectGroups();
+    InstallHooks();
     WindowFocus();
+    ConfigWatcher();
+    FrameTimeCapture();
+    DiagnosticsReport();
     return true;
 }
 
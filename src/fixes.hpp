@@ -0,0 +1,147 @@
+#pragma once
+
+#include "hooks.hpp"
+#include "leanhook.hpp"
+#include "patch.hpp"
+#include "signatures.hpp"
+
+#include <safetyhook.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// A fix is a list of sites, each one a spot in the game's code found through a signature from
+// signatures.hpp plus an offset from that signature's resolved target. Sites of one fix are listed next to each other
+// and the fix is only applied when every one of its signatures resolved, the same all-or-nothing
+// rule the hand written fixes used to apply.
+namespace Fixes
+{
+    // Only queues the site's hook or patch in the batch, which writes it to the game under one freeze
+    // when the site's feature is on and puts the original back when it goes off. Never writes to game
+    // memory itself, since PrepareFixes installs every feature whether or not the ini enables it.
+    using Install = bool (*)(HookBatch& batch, std::uint8_t* address, Applies applies);
+
+    struct Site
+    {
+        const char* fix;            // Shared by every site of the fix, also the log prefix
+        const char* signature;
+        std::int32_t offset;        // Added to the signature's target, may be negative
+        Feature feature;            // Ini toggle that owns the site
+        Applies applies;
+        Install install;
+    };
+
+    // The callback's parameter decides the hook: SafetyHookContext& for a full mid hook,
+    // LeanHook::Context<Regs...>& for a lean one that only sees Regs.
+    template<typename Callback>
+    struct HookKind;
+
+    template<>
+    struct HookKind<void (*)(SafetyHookContext&)>
+    {
+        static bool Create(HookBatch& batch, std::uint8_t* address, void (*callback)(SafetyHookContext&), Applies applies)
+        {
+            return batch.Create(address, callback, applies);
+        }
+    };
+
+    template<LeanHook::Reg... Regs>
+    struct HookKind<void (*)(LeanHook::Context<Regs...>&)>
+    {
+        static bool Create(HookBatch& batch, std::uint8_t* address, LeanHook::Fn<Regs...> callback, Applies applies)
+        {
+            return batch.Create<Regs...>(address, callback, applies);
+        }
+    };
+
+    // Prepares a hook at address that runs Callback. The batch owns the hook.
+    template<auto Callback>
+    bool InstallHook(HookBatch& batch, std::uint8_t* address, Applies applies)
+    {
+        return HookKind<decltype(Callback)>::Create(batch, address, Callback, applies);
+    }
+
+    template<auto Callback>
+    constexpr Site Hook(const char* fix, const char* signature, std::int32_t offset, Feature feature, Applies applies = Applies::Always)
+    {
+        return { fix, signature, offset, feature, applies, &InstallHook<Callback> };
+    }
+
+    // Queues Bytes to be written at address, e.g. a changed displacement. The batch owns the patch.
+    template<std::uint8_t... Bytes>
+    bool InstallPatch(HookBatch& batch, std::uint8_t* address, Applies applies)
+    {
+        static_assert(sizeof...(Bytes) > 0 && sizeof...(Bytes) <= BytePatch::MaxSize);
+        static constexpr std::uint8_t bytes[] = { Bytes... };
+        return batch.Create(address, bytes, sizeof...(Bytes), applies);
+    }
+
+    template<std::uint8_t... Bytes>
+    constexpr Site Patch(const char* fix, const char* signature, std::int32_t offset, Feature feature, Applies applies = Applies::Always)
+    {
+        return { fix, signature, offset, feature, applies, &InstallPatch<Bytes...> };
+    }
+
+    // Every site names a known signature whose target stays in the code it matched, not a pointer
+    // read out of it, and no fix is split across the registry.
+    template<std::size_t N>
+    consteval bool Valid(const Site (&registry)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            auto known = std::any_of(std::begin(GameSignatures::All), std::end(GameSignatures::All), [&](const GameSignatures::Entry& entry) {
+                return std::string_view(entry.name) == registry[i].signature &&
+                    std::all_of(entry.target.begin(), entry.target.end(), [](const Resolve::Step& step) { return step.op == Resolve::Op::Add; });
+            });
+            if (!known)
+                return false;
+
+            for (std::size_t j = i + 1; j < N; ++j) {
+                if (std::string_view(registry[j].fix) == registry[i].fix && std::string_view(registry[j - 1].fix) != registry[i].fix)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Where a site sits counted from its signature's match rather than its target.
+    struct MatchOffset
+    {
+        const char* signature;
+        std::int32_t offset;
+    };
+
+    constexpr std::int32_t TargetOffset(std::string_view signature)
+    {
+        std::int32_t offset = 0;
+        for (const auto& entry : GameSignatures::All) {
+            if (signature != entry.name)
+                continue;
+            for (const auto& step : entry.target)
+                offset += step.value;
+        }
+        return offset;
+    }
+
+    // Every site on a signature whose target isn't the match itself lands on exactly one of expected,
+    // and each expected address has exactly one site, so moving a target can't silently move a hook.
+    template<std::size_t N, std::size_t M>
+    consteval bool SameAddresses(const Site (&registry)[N], const MatchOffset (&expected)[M])
+    {
+        auto lands = [](const Site& site, const MatchOffset& address) {
+            return std::string_view(site.signature) == address.signature && site.offset + TargetOffset(site.signature) == address.offset;
+        };
+
+        for (const auto& site : registry) {
+            if (TargetOffset(site.signature) != 0 &&
+                std::count_if(std::begin(expected), std::end(expected), [&](const MatchOffset& address) { return lands(site, address); }) != 1)
+                return false;
+        }
+        for (const auto& address : expected) {
+            if (std::count_if(std::begin(registry), std::end(registry), [&](const Site& site) { return lands(site, address); }) != 1)
+                return false;
+        }
+        return true;
+    }
+}
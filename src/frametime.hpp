@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+// Frame time capture and frame pacing statistics. The recorder is fed one timestamp per frame
+// from the game thread, everything else runs on a background thread. No Windows dependencies,
+// timestamps are plain ticks at a caller supplied frequency (QPC on Windows).
+namespace FrameTime
+{
+    // Single producer ring of frame timestamps. The consumer keeps its own cursor and skips
+    // ahead if it falls more than a full ring behind, so the game thread never waits.
+    template<std::size_t Capacity = 8192>
+    class Recorder
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        void Push(std::int64_t ticks)
+        {
+            auto index = head.load(std::memory_order_relaxed);
+            ring[index & (Capacity - 1)].store(ticks, std::memory_order_relaxed);
+            head.store(index + 1, std::memory_order_release);
+        }
+
+        // Appends every timestamp pushed since the last call and returns how many were lost to overruns.
+        std::uint64_t Drain(std::vector<std::int64_t>& out)
+        {
+            auto end = head.load(std::memory_order_acquire);
+            std::uint64_t lost = 0;
+            if (end - cursor > Capacity) {
+                lost = end - cursor - Capacity;
+                cursor = end - Capacity;
+            }
+
+            auto start = cursor;
+            auto first = out.size();
+            for (; cursor != end; ++cursor)
+                out.push_back(ring[cursor & (Capacity - 1)].load(std::memory_order_relaxed));
+
+            // The producer may have lapped us while copying, drop anything it could have overwritten,
+            // including the slot of the push that may be in flight
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto now = head.load(std::memory_order_relaxed) + 1;
+            if (now - start > Capacity) {
+                auto stale = (std::min)(now - start - Capacity, end - start);
+                out.erase(out.begin() + first, out.begin() + first + stale);
+                lost += stale;
+            }
+            return lost;
+        }
+
+    private:
+        std::array<std::atomic<std::int64_t>, Capacity> ring{};
+        alignas(64) std::atomic<std::uint64_t> head{ 0 };
+        alignas(64) std::uint64_t cursor = 0;
+    };
+
+    // Converts consecutive timestamps to frame times in milliseconds.
+    inline std::vector<double> FrameTimes(const std::vector<std::int64_t>& timestamps, std::int64_t frequency)
+    {
+        std::vector<double> frameTimes;
+        if (timestamps.size() < 2 || frequency <= 0)
+            return frameTimes;
+
+        frameTimes.reserve(timestamps.size() - 1);
+        for (std::size_t i = 1; i < timestamps.size(); ++i)
+            frameTimes.push_back((timestamps[i] - timestamps[i - 1]) * 1000.0 / frequency);
+        return frameTimes;
+    }
+
+    struct Stats
+    {
+        std::size_t frames = 0;
+        double averageMs = 0;
+        double averageFps = 0;
+        double p50Ms = 0;
+        double p90Ms = 0;
+        double p99Ms = 0;
+        double p999Ms = 0;
+        double maxMs = 0;
+        double low1Fps = 0;         // Average fps over the slowest 1% of frames
+        double low01Fps = 0;        // Average fps over the slowest 0.1% of frames
+        std::size_t stutters = 0;   // Frames slower than stutterFactor times the median
+    };
+
+    inline Stats Analyse(const std::vector<double>& frameTimes, double stutterFactor = 2.0)
+    {
+        Stats stats;
+        stats.frames = frameTimes.size();
+        if (frameTimes.empty())
+            return stats;
+
+        auto sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        auto total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+        stats.averageMs = total / sorted.size();
+        stats.averageFps = stats.averageMs > 0 ? 1000.0 / stats.averageMs : 0;
+        stats.maxMs = sorted.back();
+
+        // Nearest-rank percentiles
+        auto percentile = [&](double fraction) {
+            auto rank = static_cast<std::size_t>(fraction * sorted.size() + 0.999999);
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        };
+        stats.p50Ms = percentile(0.50);
+        stats.p90Ms = percentile(0.90);
+        stats.p99Ms = percentile(0.99);
+        stats.p999Ms = percentile(0.999);
+
+        auto low = [&](double fraction) {
+            auto count = (std::max)(std::size_t(1), static_cast<std::size_t>(sorted.size() * fraction));
+            auto slowest = std::accumulate(sorted.end() - count, sorted.end(), 0.0) / count;
+            return slowest > 0 ? 1000.0 / slowest : 0;
+        };
+        stats.low1Fps = low(0.01);
+        stats.low01Fps = low(0.001);
+
+        auto threshold = stats.p50Ms * stutterFactor;
+        stats.stutters = static_cast<std::size_t>(std::count_if(frameTimes.begin(), frameTimes.end(), [threshold](double ms) { return ms > threshold; }));
+        return stats;
+    }
+
+    // One row per frame: index, time since the first frame and the frame time, all in milliseconds.
+    inline bool WriteCsv(const std::filesystem::path& path, const std::vector<double>& frameTimes)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            return false;
+
+        file << "frame,time_ms,frametime_ms\n";
+        double elapsed = 0;
+        for (std::size_t i = 0; i < frameTimes.size(); ++i) {
+            elapsed += frameTimes[i];
+            file << i << ',' << elapsed << ',' << frameTimes[i] << '\n';
+        }
+        return static_cast<bool>(file.flush());
+    }
+}
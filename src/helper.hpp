@@ -1,4 +1,9 @@
+#pragma once
 #include "stdafx.h"
+#include "cache.hpp"
+#include "pe.hpp"
+#include "resolve.hpp"
+#include "scanner.hpp"
 #include <stdio.h>
 
 using namespace std;
@@ -38,52 +43,115 @@ namespace Memory
         return ntHeaders->FileHeader.TimeDateStamp;
     }
 
-    // CSGOSimple's pattern scan
-    // https://github.com/OneshotGH/CSGOSimple-master/blob/master/CSGOSimple/helpers/utils.cpp
-    std::uint8_t* PatternScan(void* module, const char* signature)
-    {
-        static auto pattern_to_byte = [](const char* pattern) {
-            auto bytes = std::vector<int>{};
-            auto start = const_cast<char*>(pattern);
-            auto end = const_cast<char*>(pattern) + strlen(pattern);
-
-            for (auto current = start; current < end; ++current) {
-                if (*current == '?') {
-                    ++current;
-                    if (*current == '?')
-                        ++current;
-                    bytes.push_back(-1);
-                }
-                else {
-                    bytes.push_back(strtoul(current, &current, 16));
-                }
-            }
-            return bytes;
-            };
+    uint32_t ModuleSize(void* module)
+    {
+        auto dosHeader = (PIMAGE_DOS_HEADER)module;
+        auto ntHeaders = (PIMAGE_NT_HEADERS)((std::uint8_t*)module + dosHeader->e_lfanew);
+        return ntHeaders->OptionalHeader.SizeOfImage;
+    }
+
+    // The whole mapped image, for resolving signature targets inside it
+    Resolve::Image ModuleImage(void* module)
+    {
+        return { reinterpret_cast<std::uint8_t*>(module), ModuleSize(module), reinterpret_cast<std::uintptr_t>(module) };
+    }
 
+    // Splits the module into one scan region per section. Falls back to the whole image if the
+    // section table can't be parsed, so callers always have something to scan.
+    std::vector<Scanner::Region> ModuleRegions(void* module)
+    {
         auto dosHeader = (PIMAGE_DOS_HEADER)module;
         auto ntHeaders = (PIMAGE_NT_HEADERS)((std::uint8_t*)module + dosHeader->e_lfanew);
 
         auto sizeOfImage = ntHeaders->OptionalHeader.SizeOfImage;
-        auto patternBytes = pattern_to_byte(signature);
         auto scanBytes = reinterpret_cast<std::uint8_t*>(module);
 
-        auto s = patternBytes.size();
-        auto d = patternBytes.data();
+        std::vector<Scanner::Region> regions;
+        if (auto image = PE::Parse(scanBytes, sizeOfImage)) {
+            for (const auto& section : image->sections) {
+                auto [offset, size] = image->Extent(section);
+                if (size)
+                    regions.push_back({ section.name, scanBytes + offset, size, section.IsExecutable() });
+            }
+        }
+
+        if (std::none_of(regions.begin(), regions.end(), [](const Scanner::Region& region) { return region.executable; }))
+            regions.push_back({ {}, scanBytes, sizeOfImage, true });
+
+        return regions;
+    }
+
+    // Originally CSGOSimple's pattern scan, now a value/mask compare anchored on the rarest byte
+    // https://github.com/OneshotGH/CSGOSimple-master/blob/master/CSGOSimple/helpers/utils.cpp
+    // Only executable sections are searched unless a section name (e.g. ".rdata") is given.
+    std::uint8_t* PatternScan(void* module, const Scanner::Signature& signature, const char* section = nullptr)
+    {
+        return const_cast<std::uint8_t*>(Scanner::Find(ModuleRegions(module), Scanner::Pattern(signature), section ? section : ""));
+    }
+
+    unsigned ScanThreads()
+    {
+        return (std::max)(1u, std::thread::hardware_concurrency());
+    }
 
-        for (auto i = 0ul; i < sizeOfImage - s; ++i) {
-            bool found = true;
-            for (auto j = 0ul; j < s; ++j) {
-                if (scanBytes[i + j] != d[j] && d[j] != -1) {
-                    found = false;
-                    break;
-                }
+    // Resolves every signature registered in the batch with a single pass over the module's sections.
+    void PatternScan(void* module, Scanner::Batch& batch, unsigned threads = ScanThreads())
+    {
+        batch.Scan(ModuleRegions(module), threads);
+    }
+
+    // Same as above, but signatures with a cached RVA are only verified in place instead of scanned for.
+    // Stale cache entries are dropped and fresh results stored. Returns how many came from the cache.
+    size_t PatternScan(void* module, Scanner::Batch& batch, Scanner::Cache& cache, unsigned threads = ScanThreads())
+    {
+        return Scanner::ScanCached(reinterpret_cast<std::uint8_t*>(module), ModuleRegions(module), batch, cache, threads);
+    }
+
+    // True once every executable region is committed and accessible.
+    bool CodeCommitted(const std::vector<Scanner::Region>& regions)
+    {
+        for (const auto& region : regions) {
+            if (!region.executable)
+                continue;
+
+            auto address = region.data;
+            while (address < region.data + region.size) {
+                MEMORY_BASIC_INFORMATION info;
+                if (!VirtualQuery(address, &info, sizeof(info)) || info.State != MEM_COMMIT || (info.Protect & (PAGE_NOACCESS | PAGE_GUARD)))
+                    return false;
+                address = reinterpret_cast<std::uint8_t*>(info.BaseAddress) + info.RegionSize;
             }
-            if (found) {
-                return &scanBytes[i];
+        }
+        return true;
+    }
+
+    // Waits until the module's code is committed and the probe pattern can be found in it, which covers
+    // executables that are still being unpacked when we're injected. A cached RVA is checked in place before
+    // falling back to a scan. Polls at a doubling interval capped at 50ms and gives up after the timeout.
+    bool WaitForCode(void* module, const Scanner::Pattern& probe, const Scanner::Cache& cache, std::chrono::milliseconds timeout)
+    {
+        auto base = reinterpret_cast<std::uint8_t*>(module);
+        auto rva = cache.Find(Scanner::Hash(probe));
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        auto interval = std::chrono::milliseconds(1);
+
+        for (;;) {
+            auto regions = ModuleRegions(module);
+            if (CodeCommitted(regions)) {
+                Scanner::Batch batch;
+                batch.Add("Probe", probe);
+                if (rva && batch.Seed("Probe", base + *rva, regions))
+                    return true;
+                batch.Scan(regions);
+                if (batch.Found())
+                    return true;
             }
+
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            Sleep(static_cast<DWORD>(interval.count()));
+            interval = (std::min)(interval * 2, std::chrono::milliseconds(50));
         }
-        return nullptr;
     }
 
     uintptr_t GetAbsolute(uintptr_t address) noexcept
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "layout.hpp"
+#include "leanhook.hpp"
+#include "patch.hpp"
+
+#include <safetyhook.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Aspect ratio classes a hook has any effect in
+enum class Applies : std::uint8_t
+{
+    Native = 1 << static_cast<int>(Layout::Aspect::Native),
+    Wider = 1 << static_cast<int>(Layout::Aspect::Wider),
+    Narrower = 1 << static_cast<int>(Layout::Aspect::Narrower),
+    NotNative = Wider | Narrower,
+    Always = Native | Wider | Narrower,
+};
+
+// Fixes that can be switched on and off as a whole while the game runs
+enum class Feature : std::uint8_t
+{
+    Core,
+    HUD,
+    FOV,
+    FramePacing,
+};
+
+constexpr std::uint32_t Bit(Feature feature) { return 1u << static_cast<int>(feature); }
+
+// Mid hooks are created disabled, which only builds their stubs and trampolines, and are then
+// enabled together under a single thread freeze instead of suspending every game thread once
+// per hook. If any hook fails to enable, the ones already enabled by that commit are disabled
+// again so the game never runs with half of a batch applied.
+//
+// With aspect groups on, only the hooks that apply to the current aspect class are enabled and
+// SetAspect() swaps the set when the resolution changes, so 16:9 runs without any of the fixes.
+// Every hook also belongs to a feature, and SetFeatures() switches whole features the same way.
+class HookBatch
+{
+public:
+    // Hooks created while it is alive belong to its feature instead of Core
+    class FeatureScope
+    {
+    public:
+        FeatureScope(HookBatch& batch, Feature feature) : batch(batch), previous(std::exchange(batch.creating, feature)) {}
+        FeatureScope(const FeatureScope&) = delete;
+        FeatureScope& operator=(const FeatureScope&) = delete;
+        ~FeatureScope() { batch.creating = previous; }
+
+    private:
+        HookBatch& batch;
+        Feature previous;
+    };
+
+    // Only the thread creating hooks may use this
+    [[nodiscard]] FeatureScope Tag(Feature feature) { return FeatureScope(*this, feature); }
+
+    // Packs the stubs and trampolines of every hook created afterwards into one region reserved near
+    // module, instead of a fresh 64KB block per allocation that doesn't fit an existing one.
+    // Returns false and keeps using the shared allocator if the region can't be reserved.
+    bool UseArena(void* module, std::size_t size)
+    {
+        auto arena = safetyhook::Allocator::create_arena(static_cast<std::uint8_t*>(module), size);
+        if (!arena)
+            return false;
+
+        allocator = std::move(*arena);
+        return true;
+    }
+
+    // Prepares a hook into slot without touching the target. The slot must outlive the batch.
+    bool Create(SafetyHookMid& slot, void* target, safetyhook::MidHookFn destination, Applies applies = Applies::Always)
+    {
+        auto hook = safetyhook::MidHook::create(allocator, target, destination, safetyhook::MidHook::StartDisabled);
+        if (!hook) {
+            slot = {};
+            return false;
+        }
+
+        slot = std::move(*hook);
+
+        std::lock_guard lock(mutex);
+        entries.push_back({ &slot, applies, creating });
+        return true;
+    }
+
+    // Same for a lean hook whose callback only sees the registers listed in Regs.
+    template<LeanHook::Reg... Regs>
+    bool Create(LeanHook::Hook& slot, void* target, std::type_identity_t<LeanHook::Fn<Regs...>> destination, Applies applies = Applies::Always)
+    {
+        if (!LeanHook::Hook::Create<Regs...>(slot, allocator, target, destination))
+            return false;
+
+        std::lock_guard lock(mutex);
+        entries.push_back({ &slot, applies, creating });
+        return true;
+    }
+
+    // Same two with a slot owned by the batch, for hooks nothing else needs to reach
+    bool Create(void* target, safetyhook::MidHookFn destination, Applies applies = Applies::Always)
+    {
+        return Create(ownedMidHooks.emplace_back(), target, destination, applies);
+    }
+
+    template<LeanHook::Reg... Regs>
+    bool Create(void* target, std::type_identity_t<LeanHook::Fn<Regs...>> destination, Applies applies = Applies::Always)
+    {
+        return Create<Regs...>(ownedLeanHooks.emplace_back(), target, destination, applies);
+    }
+
+    // Queues a constant patch, which Commit() applies under the same freeze as the hooks. Returns false
+    // if the instruction isn't "movss reg, [disp32]" with the constant inside image, so the caller can
+    // hook it instead.
+    bool Create(ConstantPatch& slot, std::uint8_t* instruction, ZydisRegister reg, const Resolve::Image& image, Applies applies = Applies::Always)
+    {
+        if (!slot.Prepare(instruction, reg, image))
+            return false;
+
+        std::lock_guard lock(mutex);
+        entries.push_back({ &slot, applies, creating });
+        return true;
+    }
+
+    // Queues a byte patch the same way. The batch owns it, writes it with the hooks under the same freeze
+    // and puts the original bytes back whenever its feature or aspect class is switched off.
+    bool Create(std::uint8_t* address, const void* bytes, std::size_t size, Applies applies = Applies::Always)
+    {
+        auto& slot = ownedBytePatches.emplace_back();
+        if (!slot.Prepare(address, bytes, size))
+            return false;
+
+        std::lock_guard lock(mutex);
+        entries.push_back({ &slot, applies, creating });
+        return true;
+    }
+
+    // Hooks committed from now on are only enabled while they apply to the current aspect class,
+    // which starts out native until SetAspect() says otherwise.
+    void UseAspectGroups()
+    {
+        std::lock_guard lock(mutex);
+        grouped = true;
+    }
+
+    // Enables the hooks prepared since the last commit and returns how many were enabled, or nothing
+    // if the commit was rolled back. Rolled back hooks are dropped so SetAspect() won't retry them.
+    std::optional<std::size_t> Commit()
+    {
+        std::lock_guard lock(mutex);
+        bool failed = false;
+
+        // Nothing may allocate while the game's threads are frozen, one of them could hold the heap lock
+        std::vector<Slot> enabled;
+        enabled.reserve(entries.size() - committed);
+
+        safetyhook::execute_while_frozen([&] {
+            for (auto i = committed; i < entries.size(); ++i) {
+                if (Wanted(entries[i], aspect, features) && !Enable(entries[i].slot, enabled)) {
+                    failed = true;
+                    break;
+                }
+            }
+
+            if (failed)
+                Undo(enabled, {});
+        });
+
+        if (failed) {
+            entries.erase(entries.begin() + committed, entries.end());
+            return std::nullopt;
+        }
+
+        committed = entries.size();
+        return enabled.size();
+    }
+
+    struct Transition
+    {
+        std::size_t enabled = 0;
+        std::size_t disabled = 0;
+    };
+
+    // Enables the committed hooks that apply to aspect and disables the rest, all under one freeze so
+    // no game thread sees a half switched set. Returns nothing and keeps the previous set if a hook
+    // fails. Don't call it from a hook callback, a frozen game thread may hold a lock the freeze needs.
+    std::optional<Transition> SetAspect(Layout::Aspect newAspect)
+    {
+        std::lock_guard lock(mutex);
+        if (!grouped)
+            return Transition{};
+
+        return Switch(newAspect, features);
+    }
+
+    // Same for a set of Bit(feature) flags. Before the first commit it only decides what gets enabled.
+    std::optional<Transition> SetFeatures(std::uint32_t newFeatures)
+    {
+        std::lock_guard lock(mutex);
+        return Switch(aspect, newFeatures);
+    }
+
+    std::size_t Pending() const
+    {
+        std::lock_guard lock(mutex);
+        return entries.size() - committed;
+    }
+
+private:
+    using Slot = std::variant<SafetyHookMid*, LeanHook::Hook*, ConstantPatch*, BytePatch*>;
+
+    struct Entry
+    {
+        Slot slot;
+        Applies applies;
+        Feature feature;
+    };
+
+    bool Wanted(const Entry& entry, Layout::Aspect currentAspect, std::uint32_t currentFeatures) const
+    {
+        if (!(currentFeatures & Bit(entry.feature)))
+            return false;
+        return !grouped || (static_cast<std::uint8_t>(entry.applies) & (1 << static_cast<int>(currentAspect)));
+    }
+
+    // Caller holds the mutex
+    std::optional<Transition> Switch(Layout::Aspect newAspect, std::uint32_t newFeatures)
+    {
+        if (newAspect == aspect && newFeatures == features)
+            return Transition{};
+
+        // Same as Commit(), reserved up front so the freeze never allocates
+        std::vector<Slot> enabled;
+        std::vector<Slot> disabled;
+        enabled.reserve(committed);
+        disabled.reserve(committed);
+        bool failed = false;
+
+        safetyhook::execute_while_frozen([&] {
+            for (std::size_t i = 0; i < committed && !failed; ++i) {
+                auto wanted = Wanted(entries[i], newAspect, newFeatures);
+                if (wanted == IsEnabled(entries[i].slot))
+                    continue;
+                failed = wanted ? !Enable(entries[i].slot, enabled) : !Disable(entries[i].slot, disabled);
+            }
+
+            if (failed)
+                Undo(enabled, disabled);
+        });
+
+        if (failed)
+            return std::nullopt;
+
+        aspect = newAspect;
+        features = newFeatures;
+        return Transition{ enabled.size(), disabled.size() };
+    }
+
+    static bool IsEnabled(Slot slot)
+    {
+        return std::visit([](auto hook) { return hook->enabled(); }, slot);
+    }
+
+    // Both record what they changed so a failed commit or switch can be undone
+    static bool Enable(Slot slot, std::vector<Slot>& done)
+    {
+        return std::visit([&](auto hook) {
+            if (!*hook || hook->enabled())
+                return true;
+            if (!hook->enable())
+                return false;
+            done.push_back(hook);
+            return true;
+        }, slot);
+    }
+
+    static bool Disable(Slot slot, std::vector<Slot>& done)
+    {
+        return std::visit([&](auto hook) {
+            if (!*hook || !hook->enabled())
+                return true;
+            if (!hook->disable())
+                return false;
+            done.push_back(hook);
+            return true;
+        }, slot);
+    }
+
+    static void Undo(const std::vector<Slot>& enabled, const std::vector<Slot>& disabled)
+    {
+        for (auto slot : enabled)
+            std::visit([](auto hook) { static_cast<void>(hook->disable()); }, slot);
+        for (auto slot : disabled)
+            std::visit([](auto hook) { static_cast<void>(hook->enable()); }, slot);
+    }
+
+    std::shared_ptr<safetyhook::Allocator> allocator = safetyhook::Allocator::global();
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::deque<SafetyHookMid> ownedMidHooks;
+    std::deque<LeanHook::Hook> ownedLeanHooks;
+    std::deque<BytePatch> ownedBytePatches;
+    std::size_t committed = 0;
+    bool grouped = false;
+    Layout::Aspect aspect = Layout::Aspect::Native;
+    std::uint32_t features = ~0u;
+    Feature creating = Feature::Core;
+};
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "scanner.hpp"
+
+#include <Zydis.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Signatures written as instructions rather than bytes, e.g. "movss xmm, abs; mulss xmm, mem".
+// Registers are only matched by class and memory operands only by form, so a signature survives a
+// build where the compiler picked different registers or moved a field, the things byte signatures
+// wildcard with ??. Code sections are decoded once into a stream of normalized instructions, and
+// every run of K instructions is hashed into a table so a lookup only verifies the few places
+// that start the same way instead of scanning the whole image. x86 only.
+namespace Instructions
+{
+    enum class Kind : std::uint8_t
+    {
+        None,
+        Gpr,    // reg: any general purpose register
+        Xmm,    // xmm
+        X87,    // st
+        Mmx,    // mm
+        Other,  // other: segment, control and the remaining register classes
+        Mem,    // mem: memory through a base or index register
+        Abs,    // abs: memory at a fixed address, e.g. a float constant
+        Imm,    // imm
+        Rel,    // rel: branch and call targets
+        Ptr,    // ptr: far pointers
+    };
+
+    constexpr std::string_view KindNames[] = { "", "reg", "xmm", "st", "mm", "other", "mem", "abs", "imm", "rel", "ptr" };
+
+    // Mnemonic in the high half, up to four operand kinds at four bits each in the low half.
+    // Zero never occurs for a decoded instruction and marks a gap in the stream.
+    using Token = std::uint32_t;
+    constexpr std::size_t MaxOperands = 4;
+
+    inline Token Pack(ZydisMnemonic mnemonic, const Kind* kinds, std::size_t count)
+    {
+        Token token = static_cast<Token>(mnemonic) << 16;
+        for (std::size_t i = 0; i < count && i < MaxOperands; ++i)
+            token |= static_cast<Token>(kinds[i]) << (i * 4);
+        return token;
+    }
+
+    inline Kind Classify(const ZydisDecodedOperand& operand)
+    {
+        switch (operand.type) {
+        case ZYDIS_OPERAND_TYPE_REGISTER:
+            switch (ZydisRegisterGetClass(operand.reg.value)) {
+            case ZYDIS_REGCLASS_GPR8:
+            case ZYDIS_REGCLASS_GPR16:
+            case ZYDIS_REGCLASS_GPR32:
+                return Kind::Gpr;
+            case ZYDIS_REGCLASS_XMM:
+                return Kind::Xmm;
+            case ZYDIS_REGCLASS_X87:
+                return Kind::X87;
+            case ZYDIS_REGCLASS_MMX:
+                return Kind::Mmx;
+            default:
+                return Kind::Other;
+            }
+        case ZYDIS_OPERAND_TYPE_MEMORY:
+            if (operand.mem.base == ZYDIS_REGISTER_NONE && operand.mem.index == ZYDIS_REGISTER_NONE)
+                return Kind::Abs;
+            return Kind::Mem;
+        case ZYDIS_OPERAND_TYPE_IMMEDIATE:
+            return operand.imm.is_relative ? Kind::Rel : Kind::Imm;
+        case ZYDIS_OPERAND_TYPE_POINTER:
+            return Kind::Ptr;
+        default:
+            return Kind::None;
+        }
+    }
+
+    inline Token Normalize(const ZydisDecodedInstruction& instruction, const ZydisDecodedOperand* operands)
+    {
+        Kind kinds[MaxOperands] = {};
+        std::size_t count = (std::min)(static_cast<std::size_t>(instruction.operand_count_visible), MaxOperands);
+        for (std::size_t i = 0; i < count; ++i)
+            kinds[i] = Classify(operands[i]);
+        return Pack(instruction.mnemonic, kinds, count);
+    }
+
+    inline std::optional<ZydisMnemonic> FindMnemonic(std::string_view name)
+    {
+        for (int i = ZYDIS_MNEMONIC_INVALID + 1; i <= ZYDIS_MNEMONIC_MAX_VALUE; ++i) {
+            auto mnemonic = static_cast<ZydisMnemonic>(i);
+            if (auto string = ZydisMnemonicGetString(mnemonic); string && name == string)
+                return mnemonic;
+        }
+        return std::nullopt;
+    }
+
+    // Parses "mnemonic kind, kind; mnemonic; ..." with the kind names above. Returns nothing if a
+    // mnemonic or kind is unknown.
+    inline std::optional<std::vector<Token>> Parse(std::string_view text)
+    {
+        auto trim = [](std::string_view s) {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+                s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+                s.remove_suffix(1);
+            return s;
+        };
+
+        std::vector<Token> sequence;
+        while (!text.empty()) {
+            auto end = (std::min)(text.find(';'), text.size());
+            auto instruction = trim(text.substr(0, end));
+            text.remove_prefix((std::min)(end + 1, text.size()));
+            if (instruction.empty())
+                continue;
+
+            auto space = (std::min)(instruction.find(' '), instruction.size());
+            auto mnemonic = FindMnemonic(instruction.substr(0, space));
+            if (!mnemonic)
+                return std::nullopt;
+
+            Kind kinds[MaxOperands] = {};
+            std::size_t count = 0;
+            auto operands = trim(instruction.substr(space));
+            while (!operands.empty()) {
+                auto comma = (std::min)(operands.find(','), operands.size());
+                auto name = trim(operands.substr(0, comma));
+                operands.remove_prefix((std::min)(comma + 1, operands.size()));
+
+                std::size_t kind = 1;
+                while (kind < std::size(KindNames) && KindNames[kind] != name)
+                    ++kind;
+                if (kind == std::size(KindNames) || count == MaxOperands)
+                    return std::nullopt;
+                kinds[count++] = static_cast<Kind>(kind);
+            }
+            sequence.push_back(Pack(*mnemonic, kinds, count));
+        }
+        return sequence;
+    }
+
+    // The inverse of Parse, for printing the signature of existing code.
+    inline std::string Format(const std::vector<Token>& sequence)
+    {
+        std::string text;
+        for (auto token : sequence) {
+            if (!text.empty())
+                text += "; ";
+            auto mnemonic = ZydisMnemonicGetString(static_cast<ZydisMnemonic>(token >> 16));
+            text += mnemonic ? mnemonic : "?";
+            for (std::size_t i = 0; i < MaxOperands; ++i) {
+                auto kind = (token >> (i * 4)) & 0xF;
+                if (!kind)
+                    break;
+                text += i ? ", " : " ";
+                text += kind < std::size(KindNames) ? KindNames[kind] : "?";
+            }
+        }
+        return text;
+    }
+
+    // Linear sweep over the executable regions. decoded(address, instruction, operands) runs for each
+    // instruction with its visible operands, gap() after bytes that didn't decode and at the end of
+    // each region. Those bytes are stepped over one at a time, which resynchronizes within a few
+    // instructions after data in a code section.
+    template<typename Decoded, typename Gap>
+    bool Sweep(const std::vector<Scanner::Region>& regions, Decoded&& decoded, Gap&& gap)
+    {
+        ZydisDecoder decoder;
+        if (!ZYAN_SUCCESS(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32)))
+            return false;
+
+        for (const auto& region : regions) {
+            if (!region.executable)
+                continue;
+
+            std::size_t offset = 0;
+            while (offset < region.size) {
+                ZydisDecoderContext context;
+                ZydisDecodedInstruction instruction;
+                ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT_VISIBLE];
+                auto data = region.data + offset;
+                if (!ZYAN_SUCCESS(ZydisDecoderDecodeInstruction(&decoder, &context, data, region.size - offset, &instruction)) ||
+                    !ZYAN_SUCCESS(ZydisDecoderDecodeOperands(&decoder, &context, &instruction, operands, instruction.operand_count_visible))) {
+                    gap();
+                    ++offset;
+                    continue;
+                }
+
+                decoded(data, instruction, operands);
+                offset += instruction.length;
+            }
+            gap();
+        }
+        return true;
+    }
+
+    class Index
+    {
+    public:
+        // Instructions per hashed run. Lookups need at least this many instructions.
+        static constexpr std::size_t K = 4;
+
+        // Decodes every executable region front to back.
+        bool Build(const std::vector<Scanner::Region>& regions)
+        {
+            tokens.clear();
+            addresses.clear();
+
+            auto decoded = Sweep(regions,
+                [&](const std::uint8_t* address, const ZydisDecodedInstruction& instruction, const ZydisDecodedOperand* operands) {
+                    tokens.push_back(Normalize(instruction, operands));
+                    addresses.push_back(address);
+                },
+                [&] { Gap(); });
+            if (!decoded)
+                return false;
+
+            Hash();
+            return true;
+        }
+
+        std::size_t Size() const { return addresses.size(); }
+
+        // Start of every place the sequence occurs, in address order. Matches never span a gap.
+        std::vector<const std::uint8_t*> Find(const std::vector<Token>& sequence) const
+        {
+            std::vector<const std::uint8_t*> matches;
+            if (sequence.size() < K || buckets.empty())
+                return matches;
+
+            auto bucket = Bucket(RunHash(sequence.data()));
+            for (auto i = buckets[bucket]; i < buckets[bucket + 1]; ++i) {
+                auto start = starts[i];
+                if (start + sequence.size() <= tokens.size() && std::equal(sequence.begin(), sequence.end(), tokens.begin() + start))
+                    matches.push_back(addresses[start]);
+            }
+            return matches;
+        }
+
+        // The normalized instructions that start in [begin, end), for turning existing code into a
+        // signature. Empty if no decoded instruction starts exactly at begin, stops at a gap.
+        std::vector<Token> Sequence(const std::uint8_t* begin, const std::uint8_t* end) const
+        {
+            auto it = std::lower_bound(addresses.begin(), addresses.end(), begin);
+            if (it == addresses.end() || *it != begin)
+                return {};
+
+            std::vector<Token> sequence;
+            for (auto i = static_cast<std::size_t>(it - addresses.begin()); i < tokens.size() && tokens[i] && addresses[i] < end; ++i)
+                sequence.push_back(tokens[i]);
+            return sequence;
+        }
+
+    private:
+        static constexpr std::uint32_t Base = 0x01000193;
+
+        // Adjacent gaps are merged, a gap has no address of its own
+        void Gap()
+        {
+            if (!tokens.empty() && tokens.back()) {
+                tokens.push_back(0);
+                addresses.push_back(addresses.back());
+            }
+        }
+
+        static std::uint32_t RunHash(const Token* run)
+        {
+            std::uint32_t hash = 0;
+            for (std::size_t i = 0; i < K; ++i)
+                hash = hash * Base + run[i];
+            return hash;
+        }
+
+        std::size_t Bucket(std::uint32_t hash) const
+        {
+            return static_cast<std::size_t>((hash * 0x9E3779B1u) >> shift);
+        }
+
+        // Buckets every run with a rolling hash and lays the run starts out bucket by bucket, so a
+        // lookup is one bucket of candidates, each in address order.
+        void Hash()
+        {
+            buckets.clear();
+            starts.clear();
+            if (tokens.size() < K)
+                return;
+
+            auto runs = tokens.size() - K + 1;
+            shift = 31;
+            while (shift > 1 && (std::size_t(1) << (32 - shift)) < runs)
+                --shift;
+            buckets.assign((std::size_t(1) << (32 - shift)) + 1, 0);
+
+            std::uint32_t power = 1;
+            for (std::size_t i = 1; i < K; ++i)
+                power *= Base;
+
+            std::vector<std::uint32_t> bucketOf(runs);
+            auto hash = RunHash(tokens.data());
+            for (std::size_t i = 0; i < runs; ++i) {
+                if (i)
+                    hash = (hash - tokens[i - 1] * power) * Base + tokens[i + K - 1];
+                bucketOf[i] = static_cast<std::uint32_t>(Bucket(hash));
+                ++buckets[bucketOf[i] + 1];
+            }
+            for (std::size_t i = 1; i < buckets.size(); ++i)
+                buckets[i] += buckets[i - 1];
+
+            starts.resize(runs);
+            auto next = buckets;
+            for (std::size_t i = 0; i < runs; ++i)
+                starts[next[bucketOf[i]]++] = static_cast<std::uint32_t>(i);
+        }
+
+        std::vector<Token> tokens;
+        std::vector<const std::uint8_t*> addresses;
+        std::vector<std::uint32_t> buckets;
+        std::vector<std::uint32_t> starts;
+        int shift = 31;
+    };
+}
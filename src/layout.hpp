@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Everything the HUD, map, minimap and movie hooks derive from the current resolution.
+// Computed once per resolution change so the hooks only load precomputed values.
+// No Windows dependencies, so the maths can be checked against a resolution matrix on any platform.
+namespace Layout
+{
+    constexpr float fNativeAspect = (float)16 / 9;
+    constexpr float fDefMinimapMulti = 0.0007812500116f;
+
+    enum class Aspect : std::uint8_t
+    {
+        Native,
+        Wider,
+        Narrower
+    };
+
+    struct alignas(64) LayoutState
+    {
+        int iResX = 1920;
+        int iResY = 1080;
+        float fAspectRatio = fNativeAspect;
+        float fAspectMultiplier = 1.0f;
+        Aspect aspect = Aspect::Native;
+
+        // 16:9 HUD area, pillarboxed when wider and letterboxed when narrower
+        float fHUDWidth = 1920.0f;
+        float fHUDHeight = 1080.0f;
+        float fHUDWidthOffset = 0.0f;
+        float fHUDHeightOffset = 0.0f;
+        int iHUDWidth = 1920;
+        int iHUDWidthOffset = 0;
+
+        // The game's 1280x720 UI canvas stretched to the current aspect ratio
+        float fCanvasWidth = 1280.0f;           // 720 * fAspectRatio
+        float fCanvasHeight = 720.0f;           // 1280 / fAspectRatio
+        float fCanvasWidthOffset = 0.0f;
+        float fCanvasHeightOffset = 0.0f;
+        float fCanvasWidthScale = 1.0f;         // fCanvasWidth / 1280
+        float fCanvasHeightScale = 1.0f;        // fCanvasHeight / 720
+
+        float fInverseAspectMultiplier = 1.0f;
+        float fInverseAspectRatio = (float)9 / 16;
+        float fFOVScale = 1.0f;                 // Horizontal tangent scale for cutscene FOV
+
+        // Minimap and map
+        float fMinimapSize = 1920 * fDefMinimapMulti;
+        float fMapAreaSize = 1920 * fDefMinimapMulti;
+        float fMapAreaMulti = fDefMinimapMulti;
+        float fMapCursorWidth = 1920.0f;
+        int iMapAreaWidth = 1920;
+        int iMinimapWidthOffset = 0;            // Quest, pawn and player markers
+        int iMinimapRingWidthOffset = 0;
+        int iMinimapHeightOffset = 0;           // Ring
+        int iMinimapMarkerHeightOffset = 0;     // Quest, pawn and player markers
+    };
+
+    inline LayoutState Compute(int iResX, int iResY)
+    {
+        LayoutState state;
+        state.iResX = iResX;
+        state.iResY = iResY;
+        state.fAspectRatio = (float)iResX / iResY;
+        state.fAspectMultiplier = state.fAspectRatio / fNativeAspect;
+        state.aspect = state.fAspectRatio > fNativeAspect ? Aspect::Wider : state.fAspectRatio < fNativeAspect ? Aspect::Narrower : Aspect::Native;
+
+        // HUD
+        state.fHUDWidth = (float)iResY * fNativeAspect;
+        state.fHUDHeight = (float)iResY;
+        state.fHUDWidthOffset = (float)(iResX - state.fHUDWidth) / 2;
+        state.fHUDHeightOffset = 0;
+        if (state.aspect == Aspect::Narrower)
+        {
+            state.fHUDWidth = (float)iResX;
+            state.fHUDHeight = (float)iResX / fNativeAspect;
+            state.fHUDWidthOffset = 0;
+            state.fHUDHeightOffset = (float)(iResY - state.fHUDHeight) / 2;
+        }
+        state.iHUDWidth = (int)state.fHUDWidth;
+        state.iHUDWidthOffset = (int)state.fHUDWidthOffset;
+
+        // UI canvas
+        state.fCanvasWidth = (float)720 * state.fAspectRatio;
+        state.fCanvasHeight = (float)1280 / state.fAspectRatio;
+        state.fCanvasWidthOffset = (float)((720 * state.fAspectRatio) - 1280) / 2;
+        state.fCanvasHeightOffset = (float)((1280 / state.fAspectRatio) - 720) / 2;
+        state.fCanvasWidthScale = state.fCanvasWidth / 1280;
+        state.fCanvasHeightScale = state.fCanvasHeight / 720;
+
+        state.fInverseAspectMultiplier = (float)1 / state.fAspectMultiplier;
+        state.fInverseAspectRatio = (float)iResY / iResX;
+        state.fFOVScale = state.fAspectRatio / fNativeAspect;
+
+        // Minimap and map
+        state.fMinimapSize = (float)iResX * fDefMinimapMulti;
+        state.fMapAreaSize = state.fHUDWidth * fDefMinimapMulti;
+        state.fMapAreaMulti = fDefMinimapMulti / state.fAspectMultiplier;
+        state.fMapCursorWidth = (float)iResX / state.fAspectMultiplier;
+        state.iMapAreaWidth = state.aspect == Aspect::Wider ? state.iHUDWidth : iResX;
+
+        int iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
+        state.iMinimapWidthOffset = (int)floorf(iOrigMinimapWidthOffset / state.fAspectMultiplier);
+        state.iMinimapRingWidthOffset = (int)floorf((iOrigMinimapWidthOffset / state.fAspectMultiplier) + state.fHUDWidthOffset);
+
+        state.iMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - state.fHUDHeight) / 2);
+        state.iMinimapMarkerHeightOffset = (int)floorf(state.iMinimapHeightOffset - ((iResY - state.fHUDHeight) / 2));
+
+        return state;
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <safetyhook.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Mid hooks for hot paths whose callbacks only look at a couple of registers. safetyhook's stub
+// builds a full Context32 on every call, including pushfd/popfd and a ret into the trampoline
+// that the return predictor always gets wrong. These stubs keep the flags with lahf/seto, leave
+// the callee-saved registers alone unless the callback declares them, and jmp to the trampoline.
+//
+// Declaring a register makes it visible to the callback. Registers that any call may clobber
+// (eax, ecx, edx, the flags and xmm0-7 on x86) are preserved either way, since the compiler is
+// free to use them inside the callback. x86 only.
+namespace LeanHook
+{
+    enum class Reg : std::uint8_t { Eax, Ecx, Edx, Ebx, Ebp, Esi, Edi, Xmm0, Xmm1, Xmm2, Xmm3, Xmm4, Xmm5, Xmm6, Xmm7 };
+
+    // What the stub stores on the stack. The callback receives a pointer to it.
+    struct Frame
+    {
+        safetyhook::Xmm xmm[8];
+        std::uint32_t ebp, edi, esi, ebx, edx, ecx, eax, flags;
+    };
+    static_assert(sizeof(Frame) == 160, "Frame must match the offsets used by the stub");
+
+    template<Reg... Regs>
+    constexpr std::uint32_t Mask() { return ((std::uint32_t(1) << static_cast<int>(Regs)) | ... | 0u); }
+
+    template<Reg R, Reg... Regs>
+    constexpr bool Declares = ((R == Regs) || ...);
+
+    // Only the declared registers are reachable, anything else in the frame is scratch.
+    template<Reg... Regs>
+    class Context
+    {
+    public:
+        std::uint32_t& eax() requires Declares<Reg::Eax, Regs...> { return frame.eax; }
+        std::uint32_t& ecx() requires Declares<Reg::Ecx, Regs...> { return frame.ecx; }
+        std::uint32_t& edx() requires Declares<Reg::Edx, Regs...> { return frame.edx; }
+        std::uint32_t& ebx() requires Declares<Reg::Ebx, Regs...> { return frame.ebx; }
+        std::uint32_t& ebp() requires Declares<Reg::Ebp, Regs...> { return frame.ebp; }
+        std::uint32_t& esi() requires Declares<Reg::Esi, Regs...> { return frame.esi; }
+        std::uint32_t& edi() requires Declares<Reg::Edi, Regs...> { return frame.edi; }
+        safetyhook::Xmm& xmm0() requires Declares<Reg::Xmm0, Regs...> { return frame.xmm[0]; }
+        safetyhook::Xmm& xmm1() requires Declares<Reg::Xmm1, Regs...> { return frame.xmm[1]; }
+        safetyhook::Xmm& xmm2() requires Declares<Reg::Xmm2, Regs...> { return frame.xmm[2]; }
+        safetyhook::Xmm& xmm3() requires Declares<Reg::Xmm3, Regs...> { return frame.xmm[3]; }
+        safetyhook::Xmm& xmm4() requires Declares<Reg::Xmm4, Regs...> { return frame.xmm[4]; }
+        safetyhook::Xmm& xmm5() requires Declares<Reg::Xmm5, Regs...> { return frame.xmm[5]; }
+        safetyhook::Xmm& xmm6() requires Declares<Reg::Xmm6, Regs...> { return frame.xmm[6]; }
+        safetyhook::Xmm& xmm7() requires Declares<Reg::Xmm7, Regs...> { return frame.xmm[7]; }
+
+    private:
+        Frame frame;
+    };
+
+    template<Reg... Regs>
+    using Fn = void (*)(Context<Regs...>& ctx);
+
+    // Stub machine code. The two absolute operands hold the offsets of the destination and trampoline
+    // slots at the end of the stub, Relocate() turns them into addresses once the stub has a home.
+    struct Code
+    {
+        std::vector<std::uint8_t> bytes;
+        std::size_t callOperand = 0;
+        std::size_t jmpOperand = 0;
+
+        std::size_t DestinationSlot() const { return bytes.size() - 8; }
+        std::size_t TrampolineSlot() const { return bytes.size() - 4; }
+    };
+
+    inline Code Assemble(std::uint32_t mask)
+    {
+        Code code;
+        auto& b = code.bytes;
+        auto emit = [&](std::initializer_list<std::uint8_t> bytes) { b.insert(b.end(), bytes); };
+        auto emit32 = [&](std::uint32_t value) {
+            for (int i = 0; i < 4; ++i)
+                b.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        };
+        // mov [esp+disp32], reg / mov reg, [esp+disp32]
+        auto store = [&](std::uint8_t reg, std::uint32_t offset) { emit({ 0x89, std::uint8_t(0x84 | reg << 3), 0x24 }); emit32(offset); };
+        auto load = [&](std::uint8_t reg, std::uint32_t offset) { emit({ 0x8B, std::uint8_t(0x84 | reg << 3), 0x24 }); emit32(offset); };
+
+        // Register numbers in ModRM encoding and the frame slot each one lives in
+        struct Slot { Reg reg; std::uint8_t encoding; std::uint32_t offset; };
+        constexpr Slot calleeSaved[] = {
+            { Reg::Ebx, 3, offsetof(Frame, ebx) },
+            { Reg::Esi, 6, offsetof(Frame, esi) },
+            { Reg::Edi, 7, offsetof(Frame, edi) },
+            { Reg::Ebp, 5, offsetof(Frame, ebp) },
+        };
+
+        // lea esp, [esp-160], unlike sub it leaves the flags alone
+        emit({ 0x8D, 0xA4, 0x24 });
+        emit32(static_cast<std::uint32_t>(-static_cast<std::int32_t>(sizeof(Frame))));
+        store(0, offsetof(Frame, eax));
+        emit({ 0x9F });                 // lahf: SF ZF AF PF CF into ah
+        emit({ 0x0F, 0x90, 0xC0 });     // seto al
+        store(0, offsetof(Frame, flags));
+        store(1, offsetof(Frame, ecx));
+        store(2, offsetof(Frame, edx));
+        for (const auto& slot : calleeSaved) {
+            if (mask & (1u << static_cast<int>(slot.reg)))
+                store(slot.encoding, slot.offset);
+        }
+        for (std::uint8_t i = 0; i < 8; ++i)
+            emit({ 0xF3, 0x0F, 0x7F, std::uint8_t(0x44 | i << 3), 0x24, std::uint8_t(i * 16) });   // movdqu [esp+i*16], xmmi
+
+        // Call the destination with a 16 byte aligned stack, keeping a copy of the frame pointer
+        // above the argument since cdecl callees may overwrite their arguments
+        emit({ 0x89, 0xE0 });               // mov eax, esp
+        emit({ 0x83, 0xE4, 0xF0 });         // and esp, -16
+        emit({ 0x83, 0xEC, 0x08 });         // sub esp, 8
+        emit({ 0x50, 0x50 });               // push eax; push eax
+        emit({ 0xFF, 0x15 });               // call [destination]
+        code.callOperand = b.size();
+        emit32(0);
+        emit({ 0x8B, 0x64, 0x24, 0x04 });   // mov esp, [esp+4]
+
+        for (std::uint8_t i = 0; i < 8; ++i)
+            emit({ 0xF3, 0x0F, 0x6F, std::uint8_t(0x44 | i << 3), 0x24, std::uint8_t(i * 16) });   // movdqu xmmi, [esp+i*16]
+        for (const auto& slot : calleeSaved) {
+            if (mask & (1u << static_cast<int>(slot.reg)))
+                load(slot.encoding, slot.offset);
+        }
+        load(2, offsetof(Frame, edx));
+        load(1, offsetof(Frame, ecx));
+        load(0, offsetof(Frame, flags));
+        emit({ 0x04, 0x7F });               // add al, 0x7F: overflows exactly when the saved OF was 1
+        emit({ 0x9E });                     // sahf
+        load(0, offsetof(Frame, eax));
+        emit({ 0x8D, 0xA4, 0x24 });         // lea esp, [esp+160]
+        emit32(sizeof(Frame));
+        emit({ 0xFF, 0x25 });               // jmp [trampoline]
+        code.jmpOperand = b.size();
+        emit32(0);
+
+        b.resize(b.size() + 8);
+        auto patch = [&](std::size_t at, std::uint32_t value) { std::memcpy(&b[at], &value, sizeof(value)); };
+        patch(code.callOperand, static_cast<std::uint32_t>(code.DestinationSlot()));
+        patch(code.jmpOperand, static_cast<std::uint32_t>(code.TrampolineSlot()));
+        return code;
+    }
+
+    // Rebases the absolute slot operands onto the address the stub will run from.
+    inline void Relocate(Code& code, std::uint32_t address)
+    {
+        for (auto at : { code.callOperand, code.jmpOperand }) {
+            std::uint32_t value;
+            std::memcpy(&value, &code.bytes[at], sizeof(value));
+            value += address;
+            std::memcpy(&code.bytes[at], &value, sizeof(value));
+        }
+    }
+
+#if SAFETYHOOK_ARCH_X86_32
+    // Owns a stub and the inline hook that jumps into it. Shaped like SafetyHookMid so HookBatch
+    // can enable and roll back both kinds together.
+    class Hook
+    {
+    public:
+        Hook() = default;
+        Hook(Hook&& other) noexcept { *this = std::move(other); }
+
+        // Unhooks before the old stub goes away
+        Hook& operator=(Hook&& other) noexcept
+        {
+            hook = std::move(other.hook);
+            stub = std::move(other.stub);
+            return *this;
+        }
+
+        explicit operator bool() const { return static_cast<bool>(hook); }
+        bool enabled() const { return hook.enabled(); }
+        auto enable() { return hook.enable(); }
+        auto disable() { return hook.disable(); }
+
+        // Prepares a disabled hook into slot. The target is only patched once the hook is enabled.
+        template<Reg... Regs>
+        static bool Create(Hook& slot, const std::shared_ptr<safetyhook::Allocator>& allocator, void* target, std::type_identity_t<Fn<Regs...>> destination)
+        {
+            slot = {};
+
+            auto code = Assemble(Mask<Regs...>());
+            auto stub = allocator->allocate(code.bytes.size());
+            if (!stub)
+                return false;
+
+            Relocate(code, static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(stub->data())));
+            std::memcpy(&code.bytes[code.DestinationSlot()], &destination, sizeof(std::uint32_t));
+            std::memcpy(stub->data(), code.bytes.data(), code.bytes.size());
+
+            auto hook = safetyhook::InlineHook::create(allocator, target, stub->data(), safetyhook::InlineHook::StartDisabled);
+            if (!hook)
+                return false;
+
+            auto trampoline = hook->trampoline().data();
+            std::memcpy(stub->data() + code.TrampolineSlot(), &trampoline, sizeof(std::uint32_t));
+
+            slot.stub = std::move(*stub);
+            slot.hook = std::move(*hook);
+            return true;
+        }
+
+    private:
+        // Declared first so the destructor restores the target before freeing the stub
+        safetyhook::Allocation stub;
+        SafetyHookInline hook;
+    };
+#endif
+}
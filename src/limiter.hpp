@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <time.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Frame limiter that sleeps for the bulk of the frame on a high resolution timer and spins for
+// the rest. The spin margin tracks how late the OS actually wakes us, so it stays short on a
+// quiet system and grows when the scheduler gets noisy.
+namespace Limiter
+{
+    // Monotonic time in nanoseconds.
+    inline std::int64_t Now()
+    {
+#if defined(_WIN32)
+        static const std::int64_t frequency = [] {
+            LARGE_INTEGER value;
+            QueryPerformanceFrequency(&value);
+            return value.QuadPart;
+        }();
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return (counter.QuadPart / frequency) * 1000000000 + (counter.QuadPart % frequency) * 1000000000 / frequency;
+#else
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return std::int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+#endif
+    }
+
+    inline void Pause()
+    {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // Blocks until roughly the given Now() time. Uses a high resolution waitable timer where the OS
+    // has one (Windows 10 1803+) and an absolute clock_nanosleep elsewhere.
+    class Sleeper
+    {
+    public:
+        Sleeper() = default;
+        Sleeper(const Sleeper&) = delete;
+        Sleeper& operator=(const Sleeper&) = delete;
+
+#if defined(_WIN32)
+        ~Sleeper()
+        {
+            if (timer)
+                CloseHandle(timer);
+        }
+
+        void Until(std::int64_t deadline)
+        {
+            auto remaining = deadline - Now();
+            if (remaining <= 0)
+                return;
+
+            if (!timer) {
+                timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+                if (!timer)
+                    timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+            }
+
+            // Relative due time in 100ns units
+            LARGE_INTEGER due;
+            due.QuadPart = -(remaining / 100);
+            if (timer && due.QuadPart < 0 && SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+                WaitForSingleObject(timer, INFINITE);
+            else
+                Sleep(static_cast<DWORD>(remaining / 1000000));
+        }
+
+    private:
+        HANDLE timer = nullptr;
+#else
+        void Until(std::int64_t deadline)
+        {
+            timespec target{ static_cast<time_t>(deadline / 1000000000), static_cast<long>(deadline % 1000000000) };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) != 0) {}
+        }
+#endif
+    };
+
+    class FrameLimiter
+    {
+    public:
+        explicit FrameLimiter(double fps = 60.0) { SetTargetFps(fps); }
+
+        void SetTargetFps(double fps)
+        {
+            period = fps > 0 ? static_cast<std::int64_t>(std::llround(1000000000.0 / fps)) : 0;
+            deadline = 0;
+        }
+
+        // Call once per frame. Returns once a full period has passed since the previous deadline.
+        // Frames that are already late reset the schedule instead of trying to catch up.
+        void Wait()
+        {
+            if (period <= 0)
+                return;
+
+            auto now = Now();
+            if (!deadline || now - deadline > period) {
+                deadline = now;
+                return;
+            }
+            deadline += period;
+
+            auto sleepUntil = deadline - Margin();
+            if (sleepUntil > now) {
+                sleeper.Until(sleepUntil);
+                Calibrate(Now() - sleepUntil);
+            }
+
+            while (Now() < deadline)
+                Pause();
+        }
+
+        // Expected oversleep plus a safety margin, in nanoseconds.
+        std::int64_t Margin() const
+        {
+            return std::clamp(static_cast<std::int64_t>(overshoot + 3 * deviation) + MinSpin, MinSpin, MaxSpin);
+        }
+
+        std::int64_t Period() const { return period; }
+
+    private:
+        static constexpr std::int64_t MinSpin = 100000;     // 0.1ms
+        static constexpr std::int64_t MaxSpin = 4000000;    // 4ms
+
+        // Exponentially weighted mean and mean absolute deviation of how late the sleep returned
+        void Calibrate(std::int64_t late)
+        {
+            auto sample = static_cast<double>((std::max)(late, std::int64_t(0)));
+            auto error = sample - overshoot;
+            overshoot += error / 16;
+            deviation += (std::abs(error) - deviation) / 16;
+        }
+
+        Sleeper sleeper;
+        std::int64_t period = 0;
+        std::int64_t deadline = 0;
+        double overshoot = 1000000;     // Start pessimistic at 1ms and let the samples pull it down
+        double deviation = 0;
+    };
+}
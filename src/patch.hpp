@@ -0,0 +1,185 @@
+#pragma once
+
+#include "helper.hpp"
+
+#include <Zydis.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// For hooks that only ever overwrote a register with a float that is fixed per resolution. The
+// movss that loads the register is repointed at a value we own, so the game reads it without a
+// detour and a resolution change is a single store. The instruction is checked with Zydis before
+// anything is written, callers fall back to a mid hook when it isn't the expected form.
+class ConstantPatch
+{
+public:
+    ConstantPatch() = default;
+    ConstantPatch(const ConstantPatch&) = delete;
+    ConstantPatch& operator=(const ConstantPatch&) = delete;
+    ~ConstantPatch() { disable(); }
+
+    // Returns the offset of the disp32 if code is "movss reg, dword ptr [disp32]", or 0 if it isn't.
+    static std::size_t DisplacementOffset(const std::uint8_t* code, ZydisRegister reg)
+    {
+        ZydisDecoder decoder;
+        if (!ZYAN_SUCCESS(ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LEGACY_32, ZYDIS_STACK_WIDTH_32)))
+            return 0;
+
+        ZydisDecodedInstruction instruction;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (!ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, code, ZYDIS_MAX_INSTRUCTION_LENGTH, &instruction, operands)))
+            return 0;
+
+        if (instruction.mnemonic != ZYDIS_MNEMONIC_MOVSS || instruction.operand_count_visible != 2)
+            return 0;
+
+        const auto& destination = operands[0];
+        const auto& source = operands[1];
+        if (destination.type != ZYDIS_OPERAND_TYPE_REGISTER || destination.reg.value != reg)
+            return 0;
+        if (source.type != ZYDIS_OPERAND_TYPE_MEMORY || source.size != 32 || source.mem.segment != ZYDIS_REGISTER_DS ||
+            source.mem.base != ZYDIS_REGISTER_NONE || source.mem.index != ZYDIS_REGISTER_NONE)
+            return 0;
+        if (instruction.raw.disp.size != 32)
+            return 0;
+
+        return instruction.raw.disp.offset;
+    }
+
+    // Checks the instruction and reads the constant it loads, which has to lie inside image.
+    // Nothing is written until enable().
+    bool Prepare(std::uint8_t* instruction, ZydisRegister reg, const Resolve::Image& image)
+    {
+        auto offset = DisplacementOffset(instruction, reg);
+        if (!offset)
+            return false;
+
+        std::uint32_t address;
+        std::memcpy(&address, instruction + offset, sizeof(address));
+        if (address < image.loadedBase)
+            return false;
+        auto constant = image.base + (address - image.loadedBase);
+        if (!image.Contains(constant, sizeof(original)))
+            return false;
+
+        displacement = instruction + offset;
+        originalDisplacement = address;
+        std::memcpy(&original, constant, sizeof(original));
+        Set(original);
+        return true;
+    }
+
+    explicit operator bool() const { return displacement != nullptr; }
+    bool enabled() const { return active; }
+
+    bool enable()
+    {
+        if (!displacement || active)
+            return static_cast<bool>(displacement);
+
+        // Someone else patched it since Prepare(), leave it alone
+        std::uint32_t current;
+        std::memcpy(&current, displacement, sizeof(current));
+        if (current != originalDisplacement)
+            return false;
+
+        Write(static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&value)));
+        active = true;
+        return true;
+    }
+
+    bool disable()
+    {
+        if (!active)
+            return true;
+
+        Write(originalDisplacement);
+        active = false;
+        return true;
+    }
+
+    // Safe to call from any thread at any time, the game sees either the old or the new value.
+    void Set(float newValue) { std::atomic_ref<float>(value).store(newValue, std::memory_order_relaxed); }
+    float Original() const { return original; }
+
+private:
+    void Write(std::uint32_t target)
+    {
+        Memory::Write(reinterpret_cast<uintptr_t>(displacement), target);
+        FlushInstructionCache(GetCurrentProcess(), displacement, sizeof(target));
+    }
+
+    std::uint8_t* displacement = nullptr;
+    std::uint32_t originalDisplacement = 0;
+    float original = 0;
+    alignas(std::atomic_ref<float>::required_alignment) float value = 0;
+    bool active = false;
+};
+
+// A few bytes of code that are only replaced while enabled and put back when disabled, so HookBatch
+// can switch the patch together with the hooks that rely on it.
+class BytePatch
+{
+public:
+    static constexpr std::size_t MaxSize = 16;
+
+    BytePatch() = default;
+    BytePatch(const BytePatch&) = delete;
+    BytePatch& operator=(const BytePatch&) = delete;
+    ~BytePatch() { disable(); }
+
+    // Keeps a copy of what is at address now. Nothing is written until enable().
+    bool Prepare(std::uint8_t* address, const void* bytes, std::size_t size)
+    {
+        if (!address || !size || size > MaxSize)
+            return false;
+
+        target = address;
+        length = size;
+        std::memcpy(replacement, bytes, size);
+        std::memcpy(original, address, size);
+        return true;
+    }
+
+    explicit operator bool() const { return target != nullptr; }
+    bool enabled() const { return active; }
+
+    bool enable()
+    {
+        if (!target || active)
+            return static_cast<bool>(target);
+
+        // Someone else patched it since Prepare(), leave it alone
+        if (std::memcmp(target, original, length) != 0)
+            return false;
+
+        Write(replacement);
+        active = true;
+        return true;
+    }
+
+    bool disable()
+    {
+        if (!active)
+            return true;
+
+        Write(original);
+        active = false;
+        return true;
+    }
+
+private:
+    void Write(const std::uint8_t* bytes)
+    {
+        Memory::PatchBytes(reinterpret_cast<uintptr_t>(target), reinterpret_cast<const char*>(bytes), static_cast<unsigned int>(length));
+        FlushInstructionCache(GetCurrentProcess(), target, length);
+    }
+
+    std::uint8_t* target = nullptr;
+    std::size_t length = 0;
+    std::uint8_t original[MaxSize] = {};
+    std::uint8_t replacement[MaxSize] = {};
+    bool active = false;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Minimal PE header parsing for images laid out the way the loader maps them.
+// Deliberately independent of Windows.h so it can run against hand-built images on any platform.
+namespace PE
+{
+    constexpr std::uint16_t DosSignature = 0x5A4D;          // IMAGE_DOS_SIGNATURE
+    constexpr std::uint32_t NtSignature = 0x00004550;       // IMAGE_NT_SIGNATURE
+    constexpr std::uint16_t OptionalMagic32 = 0x10B;        // IMAGE_NT_OPTIONAL_HDR32_MAGIC
+    constexpr std::uint16_t OptionalMagic64 = 0x20B;        // IMAGE_NT_OPTIONAL_HDR64_MAGIC
+    constexpr std::uint32_t SectionCode = 0x00000020;       // IMAGE_SCN_CNT_CODE
+    constexpr std::uint32_t SectionExecute = 0x20000000;    // IMAGE_SCN_MEM_EXECUTE
+
+    struct Section
+    {
+        std::string name;
+        std::uint32_t virtualAddress = 0;
+        std::uint32_t virtualSize = 0;
+        std::uint32_t sizeOfRawData = 0;
+        std::uint32_t pointerToRawData = 0;
+        std::uint32_t characteristics = 0;
+
+        bool IsExecutable() const { return (characteristics & SectionExecute) != 0; }
+    };
+
+    struct Image
+    {
+        std::uint16_t machine = 0;
+        std::uint32_t timestamp = 0;
+        std::uint32_t imageBase = 0;
+        std::uint32_t sizeOfImage = 0;
+        std::uint32_t sizeOfHeaders = 0;
+        std::vector<Section> sections;
+
+        const Section* FindSection(const std::string& name) const
+        {
+            for (const auto& section : sections) {
+                if (section.name == name)
+                    return &section;
+            }
+            return nullptr;
+        }
+
+        // Section extent clamped to the image, VirtualSize is zero in some linkers' output.
+        std::pair<std::uint32_t, std::uint32_t> Extent(const Section& section) const
+        {
+            auto size = section.virtualSize ? section.virtualSize : section.sizeOfRawData;
+            auto start = (std::min)(section.virtualAddress, sizeOfImage);
+            auto end = static_cast<std::uint32_t>(std::min<std::uint64_t>(static_cast<std::uint64_t>(start) + size, sizeOfImage));
+            return { start, end - start };
+        }
+    };
+
+    template<typename T>
+    T Read(const std::uint8_t* data, std::size_t offset)
+    {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+
+    // Parses the headers of an image that is readable for at least `size` bytes.
+    // Returns nothing if the headers are malformed or extend past `size`.
+    inline std::optional<Image> Parse(const std::uint8_t* base, std::size_t size)
+    {
+        if (size < 0x40 || Read<std::uint16_t>(base, 0) != DosSignature)
+            return std::nullopt;
+
+        auto ntOffset = static_cast<std::size_t>(Read<std::uint32_t>(base, 0x3C));
+        if (ntOffset > size || size - ntOffset < 24 || Read<std::uint32_t>(base, ntOffset) != NtSignature)
+            return std::nullopt;
+
+        Image image;
+        auto fileHeader = ntOffset + 4;
+        image.machine = Read<std::uint16_t>(base, fileHeader);
+        auto numberOfSections = Read<std::uint16_t>(base, fileHeader + 2);
+        image.timestamp = Read<std::uint32_t>(base, fileHeader + 4);
+        auto sizeOfOptionalHeader = Read<std::uint16_t>(base, fileHeader + 16);
+
+        auto optionalHeader = fileHeader + 20;
+        if (optionalHeader + 64 > size)
+            return std::nullopt;
+
+        auto magic = Read<std::uint16_t>(base, optionalHeader);
+        if (magic != OptionalMagic32 && magic != OptionalMagic64)
+            return std::nullopt;
+
+        // ImageBase is only 32-bit in PE32, PE32+ images are not loaded by this game anyway.
+        image.imageBase = magic == OptionalMagic32 ? Read<std::uint32_t>(base, optionalHeader + 28) : 0;
+        image.sizeOfImage = Read<std::uint32_t>(base, optionalHeader + 56);
+        image.sizeOfHeaders = Read<std::uint32_t>(base, optionalHeader + 60);
+
+        auto sectionTable = optionalHeader + sizeOfOptionalHeader;
+        if (sectionTable + static_cast<std::size_t>(numberOfSections) * 40 > size)
+            return std::nullopt;
+
+        for (std::uint16_t i = 0; i < numberOfSections; ++i) {
+            auto header = sectionTable + static_cast<std::size_t>(i) * 40;
+
+            Section section;
+            char name[9] = {};
+            std::memcpy(name, base + header, 8);
+            section.name = name;
+            section.virtualSize = Read<std::uint32_t>(base, header + 8);
+            section.virtualAddress = Read<std::uint32_t>(base, header + 12);
+            section.sizeOfRawData = Read<std::uint32_t>(base, header + 16);
+            section.pointerToRawData = Read<std::uint32_t>(base, header + 20);
+            section.characteristics = Read<std::uint32_t>(base, header + 36);
+            image.sections.push_back(std::move(section));
+        }
+
+        std::sort(image.sections.begin(), image.sections.end(), [](const Section& a, const Section& b) {
+            return a.virtualAddress < b.virtualAddress;
+            });
+        return image;
+    }
+
+    // Lays a PE file read from disk out the way the loader maps it: headers at the start, each
+    // section's raw data at its virtual address and zeros everywhere else.
+    inline std::optional<std::vector<std::uint8_t>> Map(const std::uint8_t* file, std::size_t size)
+    {
+        auto image = Parse(file, size);
+        if (!image || image->sizeOfImage == 0)
+            return std::nullopt;
+
+        std::vector<std::uint8_t> mapped(image->sizeOfImage);
+        std::memcpy(mapped.data(), file, (std::min)({ size, static_cast<std::size_t>(image->sizeOfHeaders), mapped.size() }));
+
+        for (const auto& section : image->sections) {
+            if (section.pointerToRawData >= size)
+                continue;
+            auto [offset, extent] = image->Extent(section);
+            auto raw = (std::min)({ static_cast<std::size_t>(section.sizeOfRawData), size - section.pointerToRawData, static_cast<std::size_t>(extent) });
+            std::memcpy(mapped.data() + offset, file + section.pointerToRawData, raw);
+        }
+        return mapped;
+    }
+}
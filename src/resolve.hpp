@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Turns a signature match into the address a fix actually wants, e.g. "match, +0xE, read the
+// abs32 operand". Each step is checked against the module image before it is taken, so a chain
+// either lands inside the image or resolves to nothing, never to match + offset off a null match.
+// Deliberately independent of Windows.h so tools can resolve against an executable on disk.
+namespace Resolve
+{
+    enum class Op : std::uint8_t
+    {
+        Add,    // Moves by a signed offset
+        Rel32,  // Follows the rel32 operand at the current address, relative to the end of the operand
+        Abs32,  // Follows the absolute 32-bit address stored at the current address
+    };
+
+    struct Step
+    {
+        Op op;
+        std::int32_t value;
+    };
+
+    // Built at compile time, e.g. Chain().Add(0x12).Abs32().
+    class Chain
+    {
+    public:
+        static constexpr std::size_t MaxSteps = 4;
+
+        constexpr Chain Add(std::int32_t offset) const { return Push({ Op::Add, offset }); }
+        constexpr Chain Rel32() const { return Push({ Op::Rel32, 0 }); }
+        constexpr Chain Abs32() const { return Push({ Op::Abs32, 0 }); }
+
+        constexpr const Step* begin() const { return steps.data(); }
+        constexpr const Step* end() const { return steps.data() + count; }
+        constexpr std::size_t Size() const { return count; }
+
+    private:
+        constexpr Chain Push(Step step) const
+        {
+            // Not a constant expression when there are too many steps, so a long chain fails to compile
+            if (count == MaxSteps)
+                throw "Resolve::Chain has too many steps";
+
+            auto chain = *this;
+            chain.steps[chain.count++] = step;
+            return chain;
+        }
+
+        std::array<Step, MaxSteps> steps{};
+        std::size_t count = 0;
+    };
+
+    // The mapped module. Absolute operands hold addresses as loaded at loadedBase, which is the
+    // mapping itself in game and the preferred ImageBase when the image was mapped from disk.
+    struct Image
+    {
+        const std::uint8_t* base = nullptr;
+        std::size_t size = 0;
+        std::uintptr_t loadedBase = 0;
+
+        bool Contains(const std::uint8_t* address, std::size_t length) const
+        {
+            return base && address >= base && static_cast<std::size_t>(address - base) <= size &&
+                length <= size - static_cast<std::size_t>(address - base);
+        }
+    };
+
+    // A resolved address, typed as what lives there. Empty if the chain left the image.
+    template<typename T = std::uint8_t>
+    class Address
+    {
+    public:
+        Address() = default;
+        explicit Address(const std::uint8_t* address) : address(address) {}
+
+        explicit operator bool() const { return address != nullptr; }
+        T* get() const { return reinterpret_cast<T*>(const_cast<std::uint8_t*>(address)); }
+        std::uintptr_t value() const { return reinterpret_cast<std::uintptr_t>(address); }
+
+        template<typename U>
+        Address<U> As() const { return Address<U>(address); }
+
+    private:
+        const std::uint8_t* address = nullptr;
+    };
+
+    // Follows chain from start. Every intermediate address, every operand read and the sizeof(T)
+    // bytes at the result must lie inside the image.
+    template<typename T = std::uint8_t>
+    Address<T> Follow(const Chain& chain, const std::uint8_t* start, const Image& image)
+    {
+        if (!start || !image.Contains(start, 1))
+            return {};
+
+        auto address = start;
+        for (const auto& step : chain) {
+            std::int64_t offset = address - image.base;
+            std::int32_t operand = 0;
+            switch (step.op) {
+            case Op::Add:
+                offset += step.value;
+                break;
+            case Op::Rel32:
+                if (!image.Contains(address, sizeof(operand)))
+                    return {};
+                std::memcpy(&operand, address, sizeof(operand));
+                offset += static_cast<std::int64_t>(sizeof(operand)) + operand;
+                break;
+            case Op::Abs32:
+                if (!image.Contains(address, sizeof(operand)))
+                    return {};
+                std::memcpy(&operand, address, sizeof(operand));
+                offset = static_cast<std::int64_t>(static_cast<std::uint32_t>(operand)) - static_cast<std::int64_t>(image.loadedBase);
+                break;
+            }
+
+            if (offset < 0 || static_cast<std::uint64_t>(offset) >= image.size)
+                return {};
+            address = image.base + offset;
+        }
+
+        if (!image.Contains(address, sizeof(T)))
+            return {};
+        return Address<T>(address);
+    }
+}
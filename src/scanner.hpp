@@ -0,0 +1,813 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SCANNER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SCANNER_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define SCANNER_X86 0
+#endif
+
+namespace Scanner
+{
+    // Converts an IDA-style signature ("F3 0F ?? ??") to bytes, -1 marks a wildcard.
+    inline std::vector<int> ParsePattern(const char* pattern)
+    {
+        auto bytes = std::vector<int>{};
+        auto start = const_cast<char*>(pattern);
+        auto end = const_cast<char*>(pattern) + strlen(pattern);
+
+        for (auto current = start; current < end; ++current) {
+            if (*current == '?') {
+                ++current;
+                if (*current == '?')
+                    ++current;
+                bytes.push_back(-1);
+            }
+            else {
+                bytes.push_back(strtoul(current, &current, 16));
+            }
+        }
+        return bytes;
+    }
+
+    // Rough byte frequencies in 32-bit x86 code, higher is more common.
+    // Used to anchor a search on the byte that produces the fewest candidate positions.
+    constexpr std::array<std::uint8_t, 256> ByteFrequency = [] {
+        std::array<std::uint8_t, 256> frequency{};
+        for (auto& f : frequency)
+            f = 20;
+
+        constexpr std::pair<std::uint8_t, std::uint8_t> common[] = {
+            { 0x00, 255 }, { 0xFF, 200 }, { 0x8B, 190 }, { 0x89, 150 }, { 0x0F, 150 }, { 0x83, 130 },
+            { 0xF3, 120 }, { 0x24, 120 }, { 0xCC, 120 }, { 0x44, 110 }, { 0xE8, 110 }, { 0x45, 100 },
+            { 0x01, 90 }, { 0x10, 90 }, { 0x4C, 90 }, { 0x74, 90 }, { 0x8D, 90 }, { 0x04, 80 },
+            { 0x08, 80 }, { 0x75, 80 }, { 0x85, 80 }, { 0xC0, 80 }, { 0x40, 70 }, { 0x11, 60 },
+            { 0x14, 60 }, { 0x50, 60 }, { 0x56, 60 }, { 0x57, 60 }, { 0xC3, 60 }, { 0xC7, 60 },
+            { 0xEB, 60 }, { 0x18, 50 }, { 0x20, 50 }, { 0x33, 50 }, { 0x51, 50 }, { 0x55, 50 },
+            { 0x59, 50 }, { 0x5E, 50 }, { 0x6A, 50 }, { 0x84, 50 }, { 0x28, 40 }, { 0x3B, 40 },
+            { 0x52, 40 }, { 0x53, 40 }, { 0x5D, 40 }, { 0x5F, 40 }, { 0xE9, 40 }, { 0x0C, 40 },
+        };
+        for (const auto& [value, f] : common)
+            frequency[value] = f;
+        return frequency;
+    }();
+
+    constexpr int HexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        return -1;
+    }
+
+    // IDA-style signature literal parsed at compile time into fixed byte/mask arrays.
+    // Malformed text is a compile error rather than a scan that silently never matches.
+    struct Signature
+    {
+        static constexpr std::size_t MaxLength = 128;
+
+        std::array<std::uint8_t, MaxLength> value{};
+        std::array<std::uint8_t, MaxLength> mask{};
+        std::size_t length = 0;
+
+        template<std::size_t N>
+        consteval Signature(const char (&text)[N])
+        {
+            // The last character is the terminator, so text[i + 1] is always in range below
+            for (std::size_t i = 0; i + 1 < N; ) {
+                if (text[i] == ' ') {
+                    ++i;
+                    continue;
+                }
+                if (length == MaxLength)
+                    throw "Signature is longer than Signature::MaxLength";
+
+                if (text[i] == '?') {
+                    i += text[i + 1] == '?' ? 2 : 1;
+                }
+                else {
+                    int byte = 0;
+                    int digits = 0;
+                    for (; i + 1 < N && text[i] != ' '; ++i, ++digits) {
+                        if (HexDigit(text[i]) < 0 || digits == 2)
+                            throw "Signature bytes must be one or two hex digits";
+                        byte = byte * 16 + HexDigit(text[i]);
+                    }
+                    value[length] = static_cast<std::uint8_t>(byte);
+                    mask[length] = 0xFF;
+                }
+                ++length;
+
+                if (i + 1 < N && text[i] != ' ')
+                    throw "Signature bytes must be separated by spaces";
+            }
+            if (length == 0)
+                throw "Signature is empty";
+        }
+    };
+
+    // Value/mask form of a signature. Wildcards have a zero mask, and both arrays are zero padded
+    // to a multiple of 32 bytes so candidates can be verified with whole-vector masked compares.
+    struct Pattern
+    {
+        static constexpr std::size_t Padding = 32;
+
+        std::vector<std::uint8_t> value;
+        std::vector<std::uint8_t> mask;
+        std::size_t length = 0;
+        std::size_t anchor = 0;
+        bool hasAnchor = false;
+
+        Pattern() = default;
+
+        explicit Pattern(const std::vector<int>& bytes)
+        {
+            Resize(bytes.size());
+            for (std::size_t i = 0; i < length; ++i) {
+                if (bytes[i] == -1)
+                    continue;
+                value[i] = static_cast<std::uint8_t>(bytes[i]);
+                mask[i] = 0xFF;
+            }
+            PickAnchor();
+        }
+
+        // Runtime strings go through the old parser, literals should use Signature instead.
+        explicit Pattern(const char* signature) : Pattern(ParsePattern(signature)) {}
+
+        explicit Pattern(const Signature& signature)
+        {
+            Resize(signature.length);
+            std::copy_n(signature.value.begin(), length, value.begin());
+            std::copy_n(signature.mask.begin(), length, mask.begin());
+            PickAnchor();
+        }
+
+        std::size_t Size() const { return length; }
+        std::size_t PaddedSize() const { return value.size(); }
+
+    private:
+        void Resize(std::size_t size)
+        {
+            length = size;
+            auto padded = (length + Padding - 1) / Padding * Padding;
+            value.assign(padded, 0);
+            mask.assign(padded, 0);
+        }
+
+        void PickAnchor()
+        {
+            for (std::size_t i = 0; i < length; ++i) {
+                if (mask[i] && (!hasAnchor || ByteFrequency[value[i]] < ByteFrequency[value[anchor]])) {
+                    anchor = i;
+                    hasAnchor = true;
+                }
+            }
+        }
+    };
+
+    inline bool Matches(const std::uint8_t* data, const Pattern& pattern)
+    {
+        for (std::size_t j = 0; j < pattern.length; ++j) {
+            if ((data[j] & pattern.mask[j]) != pattern.value[j])
+                return false;
+        }
+        return true;
+    }
+
+    // Reference implementation, every other kernel must return exactly what this returns.
+    inline const std::uint8_t* FindScalar(const std::uint8_t* data, std::size_t size, const Pattern& pattern)
+    {
+        if (size < pattern.length)
+            return nullptr;
+
+        for (std::size_t i = 0; i + pattern.length <= size; ++i) {
+            if (Matches(data + i, pattern))
+                return data + i;
+        }
+        return nullptr;
+    }
+
+#if SCANNER_X86
+    inline unsigned long LowestBit(std::uint32_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return index;
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    inline bool MatchesSSE2(const std::uint8_t* data, const std::uint8_t* end, const Pattern& pattern)
+    {
+        if (static_cast<std::size_t>(end - data) < pattern.PaddedSize())
+            return Matches(data, pattern);
+
+        for (std::size_t k = 0; k < pattern.PaddedSize(); k += 16) {
+            auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + k));
+            auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.mask.data() + k));
+            auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.value.data() + k));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, mask), value)) != 0xFFFF)
+                return false;
+        }
+        return true;
+    }
+
+    inline const std::uint8_t* FindSSE2(const std::uint8_t* data, std::size_t size, const Pattern& pattern)
+    {
+        if (size < pattern.length)
+            return nullptr;
+        if (!pattern.hasAnchor)
+            return data;
+
+        const auto end = data + size;
+        const auto anchorByte = pattern.value[pattern.anchor];
+        const auto anchors = data + pattern.anchor;
+        const auto count = size - pattern.length + 1;
+        const auto needle = _mm_set1_epi8(static_cast<char>(anchorByte));
+
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(anchors + i));
+            auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+            while (bits) {
+                auto candidate = data + i + LowestBit(bits);
+                if (MatchesSSE2(candidate, end, pattern))
+                    return candidate;
+                bits &= bits - 1;
+            }
+        }
+        for (; i < count; ++i) {
+            if (anchors[i] == anchorByte && Matches(data + i, pattern))
+                return data + i;
+        }
+        return nullptr;
+    }
+
+    SCANNER_TARGET_AVX2 inline bool MatchesAVX2(const std::uint8_t* data, const std::uint8_t* end, const Pattern& pattern)
+    {
+        if (static_cast<std::size_t>(end - data) < pattern.PaddedSize())
+            return Matches(data, pattern);
+
+        for (std::size_t k = 0; k < pattern.PaddedSize(); k += 32) {
+            auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + k));
+            auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.mask.data() + k));
+            auto value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.value.data() + k));
+            if (static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(bytes, mask), value))) != 0xFFFFFFFF)
+                return false;
+        }
+        return true;
+    }
+
+    SCANNER_TARGET_AVX2 inline const std::uint8_t* FindAVX2(const std::uint8_t* data, std::size_t size, const Pattern& pattern)
+    {
+        if (size < pattern.length)
+            return nullptr;
+        if (!pattern.hasAnchor)
+            return data;
+
+        const auto end = data + size;
+        const auto anchorByte = pattern.value[pattern.anchor];
+        const auto anchors = data + pattern.anchor;
+        const auto count = size - pattern.length + 1;
+        const auto needle = _mm256_set1_epi8(static_cast<char>(anchorByte));
+
+        std::size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(anchors + i));
+            auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+            while (bits) {
+                auto candidate = data + i + LowestBit(bits);
+                if (MatchesAVX2(candidate, end, pattern))
+                    return candidate;
+                bits &= bits - 1;
+            }
+        }
+        for (; i < count; ++i) {
+            if (anchors[i] == anchorByte && Matches(data + i, pattern))
+                return data + i;
+        }
+        return nullptr;
+    }
+
+    inline bool HasAVX2()
+    {
+        std::uint32_t ecx1 = 0, ebx7 = 0;
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        ecx1 = info[2];
+        __cpuidex(info, 7, 0);
+        ebx7 = info[1];
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0, nullptr) < 7 || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        ecx1 = ecx;
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        ebx7 = ebx;
+#endif
+        // OSXSAVE and AVX, then check the OS actually saves YMM state.
+        if ((ecx1 & (1u << 27)) == 0 || (ecx1 & (1u << 28)) == 0)
+            return false;
+#if defined(_MSC_VER)
+        auto xcr0 = _xgetbv(0);
+#else
+        std::uint32_t xcr0Low, xcr0High;
+        __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        auto xcr0 = xcr0Low;
+#endif
+        return (xcr0 & 0x6) == 0x6 && (ebx7 & (1u << 5)) != 0;
+    }
+#endif
+
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    inline Kernel BestKernel()
+    {
+#if SCANNER_X86
+        static const Kernel kernel = HasAVX2() ? Kernel::AVX2 : Kernel::SSE2;
+        return kernel;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    inline const char* KernelName(Kernel kernel)
+    {
+        switch (kernel) {
+        case Kernel::AVX2: return "AVX2";
+        case Kernel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    // Returns the lowest address matching the pattern, or nullptr.
+    inline const std::uint8_t* Find(const std::uint8_t* data, std::size_t size, const Pattern& pattern, Kernel kernel = BestKernel())
+    {
+#if SCANNER_X86
+        if (kernel == Kernel::AVX2)
+            return FindAVX2(data, size, pattern);
+        if (kernel == Kernel::SSE2)
+            return FindSSE2(data, size, pattern);
+#endif
+        return FindScalar(data, size, pattern);
+    }
+
+    // A scannable byte range, usually one section of a mapped image.
+    struct Region
+    {
+        std::string name;
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        bool executable = true;
+    };
+
+    // Returns the lowest address matching the pattern across the regions, or nullptr.
+    // Regions must be ordered by address. An empty section name searches every executable region.
+    inline const std::uint8_t* Find(const std::vector<Region>& regions, const Pattern& pattern, const std::string& section = {})
+    {
+        for (const auto& region : regions) {
+            if (section.empty() ? !region.executable : region.name != section)
+                continue;
+            if (auto result = Find(region.data, region.size, pattern))
+                return result;
+        }
+        return nullptr;
+    }
+
+    // Masked compare of a whole pattern at data, with the kernel's vector width where it fits before end.
+    inline bool Matches(const std::uint8_t* data, const std::uint8_t* end, const Pattern& pattern, Kernel kernel)
+    {
+#if SCANNER_X86
+        if (kernel == Kernel::AVX2)
+            return MatchesAVX2(data, end, pattern);
+        if (kernel == Kernel::SSE2)
+            return MatchesSSE2(data, end, pattern);
+#endif
+        return Matches(data, pattern);
+    }
+
+    // A set of anchor bytes. Visit(i) runs for every position in [begin, end) whose byte is in the set,
+    // in increasing order, until it returns false. The vector kernels test a whole block at once.
+    class AnchorSet
+    {
+    public:
+        void Clear()
+        {
+            members.fill(false);
+            bytes.clear();
+        }
+
+        void Insert(std::uint8_t byte)
+        {
+            if (!std::exchange(members[byte], true))
+                bytes.push_back(byte);
+        }
+
+        bool Contains(std::uint8_t byte) const { return members[byte]; }
+        bool Empty() const { return bytes.empty(); }
+
+        template<typename Visit>
+        bool ForEach(const std::uint8_t* data, std::size_t begin, std::size_t end, Kernel kernel, Visit&& visit) const
+        {
+#if SCANNER_X86
+            if (kernel == Kernel::AVX2)
+                return ForEachAVX2(data, begin, end, visit);
+            if (kernel == Kernel::SSE2 && bytes.size() <= MaxNeedlesSSE2)
+                return ForEachSSE2(data, begin, end, visit);
+#endif
+            return ForEachScalar(data, begin, end, visit);
+        }
+
+    private:
+        // Past this many distinct bytes one compare per byte costs more than the table lookup it replaces
+        static constexpr std::size_t MaxNeedlesSSE2 = 8;
+
+        template<typename Visit>
+        bool ForEachScalar(const std::uint8_t* data, std::size_t begin, std::size_t end, Visit& visit) const
+        {
+            for (auto i = begin; i < end; ++i) {
+                if (members[data[i]] && !visit(i))
+                    return false;
+            }
+            return true;
+        }
+
+#if SCANNER_X86
+        template<typename Visit>
+        bool ForEachBits(std::uint32_t bits, std::size_t i, Visit& visit) const
+        {
+            for (; bits; bits &= bits - 1) {
+                if (!visit(i + LowestBit(bits)))
+                    return false;
+            }
+            return true;
+        }
+
+        template<typename Visit>
+        bool ForEachSSE2(const std::uint8_t* data, std::size_t begin, std::size_t end, Visit& visit) const
+        {
+            __m128i needles[MaxNeedlesSSE2];
+            for (std::size_t n = 0; n < bytes.size(); ++n)
+                needles[n] = _mm_set1_epi8(static_cast<char>(bytes[n]));
+
+            auto i = begin;
+            for (; i + 16 <= end; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                auto hits = _mm_setzero_si128();
+                for (std::size_t n = 0; n < bytes.size(); ++n)
+                    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[n]));
+                if (!ForEachBits(static_cast<std::uint32_t>(_mm_movemask_epi8(hits)), i, visit))
+                    return false;
+            }
+            return ForEachScalar(data, i, end, visit);
+        }
+
+        // Exact set membership for any number of bytes with two table lookups per block: the low
+        // nibble picks a row of the 16x16 membership bitmap and the high nibble picks a bit in it.
+        template<typename Visit>
+        SCANNER_TARGET_AVX2 bool ForEachAVX2(const std::uint8_t* data, std::size_t begin, std::size_t end, Visit& visit) const
+        {
+            alignas(16) std::uint8_t lowRows[16] = {};
+            alignas(16) std::uint8_t highRows[16] = {};
+            alignas(16) std::uint8_t bitOf[16] = {};
+            for (auto byte : bytes)
+                (byte >> 4 < 8 ? lowRows : highRows)[byte & 0xF] |= static_cast<std::uint8_t>(1u << ((byte >> 4) & 7));
+            for (int h = 0; h < 16; ++h)
+                bitOf[h] = static_cast<std::uint8_t>(1u << (h & 7));
+
+            const auto low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(lowRows)));
+            const auto high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(highRows)));
+            const auto bit = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(bitOf)));
+            const auto nibble = _mm256_set1_epi8(0x0F);
+            const auto seven = _mm256_set1_epi8(7);
+
+            auto i = begin;
+            for (; i + 32 <= end; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto lo = _mm256_and_si256(block, nibble);
+                auto hi = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+                auto row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low, lo), _mm256_shuffle_epi8(high, lo), _mm256_cmpgt_epi8(hi, seven));
+                auto miss = _mm256_cmpeq_epi8(_mm256_and_si256(row, _mm256_shuffle_epi8(bit, hi)), _mm256_setzero_si256());
+                if (!ForEachBits(~static_cast<std::uint32_t>(_mm256_movemask_epi8(miss)), i, visit))
+                    return false;
+            }
+            return ForEachScalar(data, i, end, visit);
+        }
+#endif
+
+        std::array<bool, 256> members{};
+        std::vector<std::uint8_t> bytes;
+    };
+
+    // Registers signatures up front and resolves all of them in one pass over a set of regions.
+    // Every signature is keyed on its rarest non-wildcard byte, so each scanned byte only
+    // costs a table lookup plus a full compare for the signatures anchored on that value.
+    class Batch
+    {
+    public:
+        struct Entry
+        {
+            std::string name;
+            std::string section;
+            Pattern pattern;
+            const std::uint8_t* result = nullptr;
+        };
+
+        // Signatures without a section are searched for in every executable region.
+        void Add(const std::string& name, const Signature& signature, const std::string& section = {})
+        {
+            Add(name, Pattern(signature), section);
+        }
+
+        void Add(const std::string& name, Pattern pattern, const std::string& section = {})
+        {
+            Entry entry{ name, section, std::move(pattern) };
+
+            auto existing = index.find(name);
+            if (existing != index.end()) {
+                entries[existing->second] = std::move(entry);
+                return;
+            }
+            index.emplace(name, entries.size());
+            entries.push_back(std::move(entry));
+        }
+
+        void Scan(const std::uint8_t* data, std::size_t size, Kernel kernel = BestKernel())
+        {
+            Scan({ Region{ {}, data, size, true } }, 1, kernel);
+        }
+
+        // Lowest matching address wins, same as a serial PatternScan per signature.
+        // Regions must be ordered by address. Entries that already have a result are skipped.
+        // With more than one thread each region is split into chunks that are scanned on a pool.
+        void Scan(const std::vector<Region>& regions, unsigned threads = 1, Kernel kernel = BestKernel())
+        {
+            if (threads <= 1) {
+                std::vector<const std::uint8_t*> results(entries.size());
+                for (const auto& region : regions)
+                    ScanRegion({ region, region.size, 0 }, results, nullptr, kernel);
+                Merge(results);
+                return;
+            }
+
+            auto chunks = Split(regions, threads);
+            std::vector<std::vector<const std::uint8_t*>> results(chunks.size(), std::vector<const std::uint8_t*>(entries.size()));
+            std::atomic<std::size_t> next{ 0 };
+
+            // Lowest chunk that found each entry so far. Later chunks drop an entry once an earlier one has it.
+            auto foundIn = std::make_unique<std::atomic<std::size_t>[]>(entries.size());
+            for (std::size_t i = 0; i < entries.size(); ++i)
+                foundIn[i] = NotFound;
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 0; t < std::min<std::size_t>(threads, chunks.size()); ++t) {
+                pool.emplace_back([&] {
+                    for (auto chunk = next++; chunk < chunks.size(); chunk = next++)
+                        ScanRegion(chunks[chunk], results[chunk], foundIn.get(), kernel);
+                    });
+            }
+            for (auto& thread : pool)
+                thread.join();
+
+            // Chunks are in address order and own disjoint match positions, so the first chunk with a hit has the lowest match.
+            for (const auto& chunk : results)
+                Merge(chunk);
+        }
+
+        // Resolves an entry from a known address, e.g. a cached RVA. The address must lie in a region
+        // the entry may match in and the bytes there must still match, otherwise nothing changes.
+        bool Seed(const std::string& name, const std::uint8_t* address, const std::vector<Region>& regions)
+        {
+            auto it = index.find(name);
+            if (it == index.end())
+                return false;
+
+            auto& entry = entries[it->second];
+            for (const auto& region : regions) {
+                if (entry.section.empty() ? !region.executable : entry.section != region.name)
+                    continue;
+                if (address < region.data || address >= region.data + region.size)
+                    continue;
+                if (static_cast<std::size_t>(address - region.data) + entry.pattern.Size() > region.size || !Matches(address, entry.pattern))
+                    return false;
+                entry.result = address;
+                return true;
+            }
+            return false;
+        }
+
+        void Reset()
+        {
+            for (auto& entry : entries)
+                entry.result = nullptr;
+        }
+
+        std::uint8_t* Get(const std::string& name) const
+        {
+            auto it = index.find(name);
+            if (it == index.end())
+                return nullptr;
+            return const_cast<std::uint8_t*>(entries[it->second].result);
+        }
+
+        std::size_t Size() const { return entries.size(); }
+        const std::vector<Entry>& Entries() const { return entries; }
+
+        std::size_t Found() const
+        {
+            std::size_t found = 0;
+            for (const auto& entry : entries) {
+                if (entry.result)
+                    ++found;
+            }
+            return found;
+        }
+
+    private:
+        static constexpr std::size_t MinimumChunk = 256 * 1024;
+        static constexpr std::size_t NotFound = ~std::size_t(0);
+
+        // How much a chunk scans between checks for entries an earlier chunk already found
+        static constexpr std::size_t Stride = 64 * 1024;
+
+        // A slice of a region. Only matches starting in the first owned bytes belong to the chunk, the
+        // rest of it is there so a match straddling the boundary is still seen whole.
+        struct Chunk
+        {
+            Region region;
+            std::size_t owned = 0;
+            std::size_t index = 0;
+        };
+
+        // Each chunk owns the match positions in [start, start + step) but also covers the next
+        // longest-pattern-minus-one bytes.
+        std::vector<Chunk> Split(const std::vector<Region>& regions, unsigned threads) const
+        {
+            std::size_t overlap = 0;
+            for (const auto& entry : entries)
+                overlap = (std::max)(overlap, entry.pattern.Size());
+            overlap = overlap ? overlap - 1 : 0;
+
+            std::size_t total = 0;
+            for (const auto& region : regions)
+                total += region.size;
+
+            // A few chunks per thread keeps the pool busy when one region is much larger than the rest.
+            auto step = (std::max)(MinimumChunk, total / (static_cast<std::size_t>(threads) * 4) + 1);
+
+            std::vector<Chunk> chunks;
+            for (const auto& region : regions) {
+                for (std::size_t start = 0; start < region.size; start += step) {
+                    auto end = (std::min)(region.size, start + step + overlap);
+                    auto owned = (std::min)(step, region.size - start);
+                    chunks.push_back({ { region.name, region.data + start, end - start, region.executable }, owned, chunks.size() });
+                    if (end == region.size)
+                        break;
+                }
+            }
+            return chunks;
+        }
+
+        void Merge(const std::vector<const std::uint8_t*>& results)
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i) {
+                if (!entries[i].result)
+                    entries[i].result = results[i];
+            }
+        }
+
+        // Fills in results for every eligible entry that doesn't have one yet. Only reads the entries,
+        // so several chunks can be scanned at once as long as each has its own results. foundIn is
+        // shared between the chunks of a threaded scan and null otherwise.
+        void ScanRegion(const Chunk& chunk, std::vector<const std::uint8_t*>& results, std::atomic<std::size_t>* foundIn, Kernel kernel) const
+        {
+            const auto data = chunk.region.data;
+            const auto size = chunk.region.size;
+            const auto end = data + size;
+
+            // Entries waiting for a match, grouped by anchor byte
+            std::array<std::vector<std::uint32_t>, 256> anchors{};
+            std::vector<std::uint32_t> waiting;
+            std::size_t maxAnchor = 0;
+
+            for (std::uint32_t i = 0; i < entries.size(); ++i) {
+                const auto& entry = entries[i];
+                if (entry.result || results[i] || (entry.section.empty() ? !chunk.region.executable : entry.section != chunk.region.name))
+                    continue;
+                if (!entry.pattern.hasAnchor) {
+                    results[i] = chunk.owned && size >= entry.pattern.Size() ? data : nullptr;
+                    continue;
+                }
+                anchors[entry.pattern.value[entry.pattern.anchor]].push_back(i);
+                waiting.push_back(i);
+                maxAnchor = (std::max)(maxAnchor, entry.pattern.anchor);
+            }
+
+            auto found = [&](std::uint32_t i) { return results[i] || (foundIn && foundIn[i].load(std::memory_order_relaxed) < chunk.index); };
+            auto drop = [&](std::uint32_t i) {
+                auto& candidates = anchors[entries[i].pattern.value[entries[i].pattern.anchor]];
+                candidates.erase(std::find(candidates.begin(), candidates.end(), i));
+            };
+
+            AnchorSet set;
+            auto check = [&](std::size_t position) {
+                auto& candidates = anchors[data[position]];
+                for (auto it = candidates.begin(); it != candidates.end(); ) {
+                    const auto& pattern = entries[*it].pattern;
+                    auto start = position - pattern.anchor;
+                    if (position < pattern.anchor || start >= chunk.owned || start + pattern.Size() > size || !Matches(data + start, end, pattern, kernel)) {
+                        ++it;
+                        continue;
+                    }
+                    results[*it] = data + start;
+                    if (foundIn) {
+                        auto lowest = foundIn[*it].load(std::memory_order_relaxed);
+                        while (chunk.index < lowest && !foundIn[*it].compare_exchange_weak(lowest, chunk.index, std::memory_order_relaxed)) {}
+                    }
+                    it = candidates.erase(it);
+                    if (candidates.empty())
+                        return false;
+                }
+                return true;
+            };
+
+            // Anchors of matches this chunk owns end before owned + maxAnchor
+            const auto scanEnd = (std::min)(size, chunk.owned + maxAnchor);
+            for (std::size_t position = 0; position < scanEnd; ) {
+                waiting.erase(std::remove_if(waiting.begin(), waiting.end(), [&](std::uint32_t i) {
+                    if (!found(i))
+                        return false;
+                    if (!results[i])
+                        drop(i);
+                    return true;
+                }), waiting.end());
+                if (waiting.empty())
+                    break;
+
+                set.Clear();
+                for (auto i : waiting)
+                    set.Insert(entries[i].pattern.value[entries[i].pattern.anchor]);
+
+                // Restarts the search with a smaller set whenever a byte runs out of candidates
+                auto strideEnd = (std::min)(scanEnd, position + Stride);
+                while (position < strideEnd) {
+                    auto next = strideEnd;
+                    set.ForEach(data, position, strideEnd, kernel, [&](std::size_t at) {
+                        if (check(at))
+                            return true;
+                        next = at + 1;
+                        return false;
+                    });
+                    position = next;
+                    if (position < strideEnd) {
+                        set.Clear();
+                        for (auto i : waiting) {
+                            if (!results[i])
+                                set.Insert(entries[i].pattern.value[entries[i].pattern.anchor]);
+                        }
+                        if (set.Empty())
+                            position = strideEnd;
+                    }
+                }
+            }
+        }
+
+        std::vector<Entry> entries;
+        std::unordered_map<std::string, std::size_t> index;
+    };
+}
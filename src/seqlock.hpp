@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Sequence lock for a small trivially copyable value with rare writes and frequent reads.
+// Readers never block the writer and never see a mix of two writes: they retry if the
+// sequence was odd (write in progress) or changed while they were copying.
+// The value is stored as relaxed atomic words so concurrent copies are well defined.
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+
+    explicit SeqLock(const T& value)
+    {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (std::size_t i = 0; i < WordCount; ++i)
+            storage[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    // Safe from several threads, concurrent writers are serialised on the sequence itself.
+    void Store(const T& value)
+    {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        auto sequence = this->sequence.load(std::memory_order_relaxed);
+        while ((sequence & 1) || !this->sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            Pause();
+            sequence = this->sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WordCount; ++i)
+            storage[i].store(words[i], std::memory_order_relaxed);
+
+        this->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T Load() const
+    {
+        Words words;
+        for (;;) {
+            auto before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                Pause();
+                continue;
+            }
+
+            for (std::size_t i = 0; i < WordCount; ++i)
+                words[i] = storage[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t WordCount = (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+    using Words = std::array<std::uint32_t, WordCount>;
+
+    static void Pause()
+    {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    alignas(64) std::atomic<std::uint32_t> sequence{ 0 };
+    std::array<std::atomic<std::uint32_t>, WordCount> storage;
+};
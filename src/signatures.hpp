@@ -0,0 +1,85 @@
+#pragma once
+
+#include "resolve.hpp"
+#include "scanner.hpp"
+
+#include <cstdint>
+
+// Every signature the fixes scan for, in one place so tools can check them against a game
+// executable on disk without Windows headers. target is the chain from the match to the instruction
+// or value the fix uses, fixes that touch several spots add further offsets of their own.
+namespace GameSignatures
+{
+    struct Entry
+    {
+        const char* name;
+        Scanner::Signature signature;
+        Resolve::Chain target;
+    };
+
+    inline constexpr Entry All[] = {
+        // Resolution
+        { "CurrentResolution", "83 ?? 08 8B ?? 89 ?? 8B ?? ?? ?? ?? ?? 8B ?? 89 ?? ?? E8 ?? ?? ?? ?? 8B ?? 89 ?? ?? ?? 3B ?? 75 ??", Resolve::Chain().Add(0xD) },
+
+        // HUD
+        { "HUDSize", "F3 0F ?? ?? ?? ?? ?? ?? 0F 57 ?? F3 0F ?? ?? 0F 28 ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F 28 ??", {} },
+        { "HUDOffset", "F3 0F ?? ?? ?? F3 0F ?? ?? ?? 83 ?? ?? FD 8B ?? ?? ?? 48 74 ?? 48 74 ??", {} },
+        { "HUDBackgrounds1", "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? 0C 0F ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ??", {} },
+        { "HUDBackgrounds2", "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? 10 0F ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ??", {} },
+        { "SubtitlesLayer", "F3 0F ?? ?? 2B ?? 8B ?? 2B ?? ?? ?? F3 0F ?? ?? ?? ??", {} },
+        { "TitleBackground", "0F 57 ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 14 F3 0F ?? ?? ?? 10 F3 0F ?? ?? ?? F3 0F ?? ?? ?? ??", {} },
+        { "MousePos", "99 F7 ?? 8B ?? ?? ?? 89 ?? 8B ?? ?? ?? 2B ?? 0F ?? ?? ?? ?? 99 F7 ??", Resolve::Chain().Add(0x7) },
+        { "MapMousePos1", "89 ?? 8B ?? ?? 5E 5D 89 ?? ?? 5B 83 ?? ?? C2 08 00", {} },
+        { "MapMousePos3", "89 ?? ?? ?? 8D ?? ?? ?? 8B ?? 89 ?? ?? ?? E8 ?? ?? ?? ?? A1 ?? ?? ?? ??", {} },
+        { "MapMousePos4", "89 ?? ?? ?? 8D ?? ?? ?? 8B ?? 89 ?? ?? ?? E8 ?? ?? ?? ?? 8B ?? ?? ?? 8B ?? ?? ?? ?? ?? 8B ?? 8B ?? ??", {} },
+        { "MenuMouse1", "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F 57 ?? F3 0F ?? ?? F3 0F ?? ??", {} },
+        { "MenuMouse2", "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 56 8B ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F 57 ?? F3 0F ?? ??", {} },
+        { "MenuMouse3", "F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 0F 57 ?? 8B ?? ?? 83 ?? FF", {} },
+        { "Scrollbar1", "0F 28 ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 75 ??", Resolve::Chain().Add(0x3) },
+        { "Scrollbar2", "66 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 8B ?? ?? ?? 0F 5B ??", Resolve::Chain().Add(0x10) },
+        { "Scrollbar3", "0F 57 ?? F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ??", {} },
+        { "Scrollbar4", "0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? 75 ?? 85 ??", Resolve::Chain().Add(0x3) },
+        { "Markers", "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 00 0F 57 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ??", {} },
+        { "MinimapWidthMulti", "66 0F ?? ?? ?? ?? ?? 00 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 D9 ?? ??", Resolve::Chain().Add(0xB) },
+        { "MinimapTexture", "F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 8B ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 8B ?? ?? ?? 89 ?? ?? ??", Resolve::Chain().Add(0x8) },
+        { "MinimapTexturePosition", "D9 ?? ?? 8B ?? ?? ?? ?? 00 8B ?? 68 ?? ?? ?? ?? 57", Resolve::Chain().Add(0x3) },
+        { "MinimapFog1", "F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ??  0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ??", {} },
+        { "MinimapFog2", "F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F 59 ?? ?? ?? ?? ??", {} },
+        { "MinimapIconHeightOffset", "F3 0F ?? ?? ?? ?? ?? 00 83 ?? ?? 01 8B ?? ?? F3 0F ?? ?? F3 0F ?? ??", {} },
+        { "MinimapHeightOffset", "0F 57 ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F 57 ?? 0F 57 ??", Resolve::Chain().Add(0x7) },
+        { "MinimapWidthOffset1", "66 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? ?? 0F 28 ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 0F 28 ?? 0F 57 ?? ?? ?? ?? ??", {} },
+        { "MinimapWidthOffset2", "66 0F ?? ?? ?? ?? ?? 00 0F 5B ?? F3 0F ?? ?? ?? ?? 66 0F ?? ?? ?? ?? ?? 00 0F 5B ??", {} },
+        { "MinimapWidthOffset3", "66 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? 0F 28 ?? F3 0F 59 ?? ?? ?? F3 0F 59 ?? ?? ??", {} },
+        { "MinimapWidthOffset4", "66 0F ?? ?? ?? ?? ?? 00 F3 0F 10 ?? ?? ?? ?? ?? F3 0F 5E ?? ?? ?? ?? 00 F3 0F 10 ?? ?? ?? ?? ??", {} },
+        { "MapFrame", "A1 ?? ?? ?? ?? 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 0F ?? ?? F3 0F ?? ?? 0F 28 ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F 59 0D ?? ?? ?? ??", {} },
+        { "MapLocationMenu", "F3 0F ?? ?? 0F 28 ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? ?? ?? ?? ?? 89 ?? ?? ?? 8B ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ?? 74 ?? 8B ?? ?? ?? ?? 00 EB ?? 33 ??", {} },
+        { "MapPosOffsetHor", "E9 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 33 ?? BE ?? ?? ?? 00", Resolve::Chain().Add(0x5) },
+        { "MapCursor1", "F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F 10 ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F 10 ?? ?? ?? ?? 00", {} },
+        { "MapCursor2", "F3 0F 59 ?? ?? ?? ?? ?? 0F 28 ?? 0F 57 ?? 89 ?? ?? ?? 8B ?? ?? 8B ?? ??", {} },
+        { "MapCursor3", "F3 0F 59 ?? ?? ?? ?? ?? 0F 5B ?? F3 0F ?? ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 5C ?? ?? ?? ?? ??", {} },
+        { "MapCursorOffset1", "0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? 66 0F ?? ?? ?? ?? ?? 00 0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? 0F 57 ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ?? 74 ??", Resolve::Chain().Add(0x3) },
+        { "MapCursorOffset2", "0F 5B ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? EB ??", Resolve::Chain().Add(0x3) },
+        { "MapCursorOffset3", "0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 33 ?? 8D ?? ?? ?? ?? 00 8B ??", Resolve::Chain().Add(0x3) },
+        { "MapIconWidthOffset1", "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? 51 F3 0F ?? ?? F3 0F ?? ?? 8B ??", {} },
+        { "MapIconWidthOffset2", "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? 8D ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 52 8B ??", {} },
+        { "MapIconWidthOffset3", "F3 0F ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 51 8B ?? ?? ??", {} },
+        { "MapIconWidthOffset4", "51 8B ?? F3 0F ?? ?? ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? 00 51 8B ??", {} },
+        { "MapIconWidthOffset5", "0F 5B ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? 00 F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? 85 ??", {} },
+        { "MapArea1", "C1 ?? 02 2B ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? D1 F8", {} },
+        { "MapArea2", "0F 5B ?? F3 0F ?? ?? 84 ?? 74 ?? 66 0F ?? ?? ?? ?? ?? 00 0F 28 ??", {} },
+        { "MapArea3", "0F 5B ?? F3 0F 59 ?? ?? ?? ?? ?? F3 0F 59 ?? F3 0F ?? ?? ?? ?? ?? 00", Resolve::Chain().Add(0xB) },
+        { "MapArea4", "F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? 8B ?? ?? 8B ?? ?? 89 ?? ?? ?? 89 ?? ?? ?? 74 ??", {} },
+        { "MapArea5", "DB ?? ?? ?? ?? 00 D8 ?? ?? ?? ?? ?? D9 ?? ?? D8 ?? ?? ?? ?? ??", {} },
+        { "Movie", "8B ?? ?? ?? 89 ?? ?? 89 ?? ?? 8B ?? E8 ?? ?? ?? ?? 8B ?? E8 ?? ?? ?? ?? 5E", {} },
+
+        // Aspect ratio and FOV
+        { "AspectRatio", "F3 0F ?? ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00 8B ?? ?? ?? ?? 00", {} },
+        { "LoadingAspect", "F3 0F 11 ?? ?? ?? EB ?? 8B ?? ?? 0F ?? ?? C1 ?? 10 89 ?? ?? ??", {} },
+        { "CutsceneFOV", "76 ?? 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 8B ?? ?? ?? 83 ?? ??", {} },
+
+        // Miscellaneous
+        { "DOFFix", "F3 0F ?? ?? ?? ?? ?? ?? 0F ?? ?? 0F ?? ?? 56 57 8B ??", {} },
+        { "FPSCap", "8B ?? ?? 83 ?? 00 74 ?? 48 74 ?? 48 75 ?? F3 0F ?? ?? ?? ?? ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? ?? EB ?? F3 0F ?? ?? ?? ?? ?? ??", Resolve::Chain().Add(0xE + 0x4).Abs32() },
+        { "WindowMode", "80 ?? ?? 00 74 ?? 8B ?? ?? 8B ?? ?? ?? ?? 00 3B ?? ?? ?? ?? 00", {} },
+    };
+}
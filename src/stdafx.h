@@ -6,4 +6,5 @@
 #include <Windows.h>
 #include <fstream>
 #include <inttypes.h>
-#include <filesystem>
\ No newline at end of file
+#include <filesystem>
+#include <chrono>
\ No newline at end of file
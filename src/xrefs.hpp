@@ -0,0 +1,134 @@
+#pragma once
+
+#include "instructions.hpp"
+#include "resolve.hpp"
+#include "scanner.hpp"
+
+#include <Zydis.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Every place the code names an address inside the module by its absolute value, memory operands
+// like "movss xmm0, [disp32]" and immediates like "push offset". Built in one decode pass, after
+// which both directions are a hash lookup, so a constant such as 720.0f can be found through the
+// code that loads it instead of through a byte signature around that code. x86 only.
+namespace Xrefs
+{
+    enum class Kind : std::uint8_t
+    {
+        Memory,     // [disp32] with no base or index
+        Immediate,  // imm32 that happens to be an address in the image
+    };
+
+    struct Reference
+    {
+        const std::uint8_t* instruction;
+        const std::uint8_t* target;
+        Kind kind;
+        std::uint8_t operandOffset;     // Where the address sits in the instruction, for repointing it
+    };
+
+    class Index
+    {
+    public:
+        bool Build(const std::vector<Scanner::Region>& regions, const Resolve::Image& moduleImage)
+        {
+            image = moduleImage;
+            references.clear();
+            byTarget.clear();
+            instructions.clear();
+            targets.clear();
+
+            auto decoded = Instructions::Sweep(regions,
+                [&](const std::uint8_t* address, const ZydisDecodedInstruction& instruction, const ZydisDecodedOperand* operands) {
+                    std::size_t immediates = 0;
+                    for (std::size_t i = 0; i < instruction.operand_count_visible; ++i) {
+                        const auto& operand = operands[i];
+                        if (operand.type == ZYDIS_OPERAND_TYPE_MEMORY && operand.mem.segment == ZYDIS_REGISTER_DS &&
+                            operand.mem.base == ZYDIS_REGISTER_NONE && operand.mem.index == ZYDIS_REGISTER_NONE && instruction.raw.disp.size == 32) {
+                            Add(address, static_cast<std::uint32_t>(operand.mem.disp.value), Kind::Memory, instruction.raw.disp.offset);
+                        }
+                        else if (operand.type == ZYDIS_OPERAND_TYPE_IMMEDIATE) {
+                            auto slot = immediates++;
+                            if (!operand.imm.is_relative && slot < 2 && instruction.raw.imm[slot].size == 32)
+                                Add(address, static_cast<std::uint32_t>(operand.imm.value.u), Kind::Immediate, instruction.raw.imm[slot].offset);
+                        }
+                    }
+                },
+                [] {});
+            if (!decoded)
+                return false;
+
+            // references is in address order already, a second copy sorted by target serves the other direction
+            for (std::size_t i = 0; i < references.size(); ++i) {
+                if (!i || references[i].instruction != references[i - 1].instruction)
+                    instructions.emplace(references[i].instruction, Range{ static_cast<std::uint32_t>(i), 0 });
+                ++instructions[references[i].instruction].count;
+            }
+
+            byTarget = references;
+            std::stable_sort(byTarget.begin(), byTarget.end(), [](const Reference& a, const Reference& b) { return a.target < b.target; });
+            for (std::size_t i = 0; i < byTarget.size(); ++i) {
+                if (!i || byTarget[i].target != byTarget[i - 1].target)
+                    targets.emplace(byTarget[i].target, Range{ static_cast<std::uint32_t>(i), 0 });
+                ++targets[byTarget[i].target].count;
+            }
+            return true;
+        }
+
+        std::size_t Size() const { return references.size(); }
+
+        // Instructions that reference target, in address order.
+        std::span<const Reference> To(const std::uint8_t* target) const
+        {
+            auto it = targets.find(target);
+            return it == targets.end() ? std::span<const Reference>() : std::span(byTarget).subspan(it->second.first, it->second.count);
+        }
+
+        // What the instruction at address references, usually one address.
+        std::span<const Reference> From(const std::uint8_t* instruction) const
+        {
+            auto it = instructions.find(instruction);
+            return it == instructions.end() ? std::span<const Reference>() : std::span(references).subspan(it->second.first, it->second.count);
+        }
+
+        // Referenced addresses that hold value, lowest first. Only addresses the code names are
+        // compared, so this is a walk over the distinct targets rather than over the data sections.
+        template<typename T>
+        std::vector<const std::uint8_t*> Constants(const T& value) const
+        {
+            std::vector<const std::uint8_t*> found;
+            for (const auto& [target, range] : targets) {
+                if (image.Contains(target, sizeof(T)) && std::memcmp(target, &value, sizeof(T)) == 0)
+                    found.push_back(target);
+            }
+            std::sort(found.begin(), found.end());
+            return found;
+        }
+
+    private:
+        struct Range
+        {
+            std::uint32_t first;
+            std::uint32_t count;
+        };
+
+        void Add(const std::uint8_t* instruction, std::uint32_t address, Kind kind, std::uint8_t operandOffset)
+        {
+            if (address < image.loadedBase || address - image.loadedBase >= image.size)
+                return;
+            references.push_back({ instruction, image.base + (address - image.loadedBase), kind, operandOffset });
+        }
+
+        Resolve::Image image;
+        std::vector<Reference> references;
+        std::vector<Reference> byTarget;
+        std::unordered_map<const std::uint8_t*, Range> instructions;
+        std::unordered_map<const std::uint8_t*, Range> targets;
+    };
+}
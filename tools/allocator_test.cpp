@@ -0,0 +1,108 @@
+// Checks the arena mode of safetyhook's allocator: slices are aligned and packed back to back,
+// a full arena falls back to new regions and reuses freed slices, and an arena that can't be
+// reserved reports an error while the shared allocator HookBatch keeps using still works.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src /I external\safetyhook tools\allocator_test.cpp external\safetyhook\safetyhook.cpp external\safetyhook\Zydis.c
+//   gcc -O2 -c external/safetyhook/Zydis.c -o Zydis.o
+//   g++ -std=c++23 -O2 -I src -I external/safetyhook tools/allocator_test.cpp external/safetyhook/safetyhook.cpp Zydis.o -o allocator_test
+
+#include "check.hpp"
+
+#include <safetyhook.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    // Stands in for the module base the arena is reserved near
+    std::uint8_t module[16];
+
+    bool Aligned(const std::uint8_t* address, std::size_t alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(address) % alignment == 0;
+    }
+
+    std::size_t AlignUp(std::size_t size, std::size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    void SlicesAreAlignedAndPacked(std::size_t alignment)
+    {
+        auto arena = safetyhook::Allocator::create_arena(module, 64 * 1024, alignment);
+        if (!CHECK(arena.has_value()))
+            return;
+
+        std::vector<safetyhook::Allocation> allocations;
+        std::uint8_t* next = nullptr;
+        for (std::size_t size : { 1, 5, 64, 65, 100, 3, 256, 300 }) {
+            auto allocation = (*arena)->allocate_near({ module }, size);
+            if (!CHECK(allocation.has_value()))
+                return;
+
+            CHECK(Aligned(allocation->data(), alignment));
+            CHECK(allocation->size() == size);
+            CHECK(!next || allocation->data() == next);
+            next = allocation->data() + AlignUp(size, alignment);
+            allocations.push_back(std::move(*allocation));
+        }
+    }
+
+    void FullArenaFallsBack()
+    {
+        constexpr std::size_t Slice = 64;
+        auto arena = safetyhook::Allocator::create_arena(module, 1, Slice);
+        if (!CHECK(arena.has_value()))
+            return;
+
+        // The arena is one allocation granule, fill it until a slice comes from somewhere else
+        std::vector<safetyhook::Allocation> allocations;
+        std::uint8_t* start = nullptr;
+        for (std::size_t i = 0; i < 1 << 16; ++i) {
+            auto allocation = (*arena)->allocate_near({ module }, Slice);
+            if (!CHECK(allocation.has_value()))
+                return;
+
+            CHECK(Aligned(allocation->data(), Slice));
+            if (!start)
+                start = allocation->data();
+            if (allocation->data() != start + i * Slice) {
+                allocations.push_back(std::move(*allocation));
+                break;
+            }
+            allocations.push_back(std::move(*allocation));
+        }
+
+        auto inArena = allocations.size() - 1;
+        auto outside = allocations.back().data();
+        CHECK(inArena > 0 && inArena * Slice % 4096 == 0);
+        CHECK(outside < start || outside >= start + inArena * Slice);
+
+        // A freed slice in the arena is handed out again before the fallback region
+        auto freed = allocations[inArena / 2].data();
+        allocations[inArena / 2] = {};
+        auto reused = (*arena)->allocate_near({ module }, Slice);
+        CHECK(reused.has_value() && reused->data() == freed);
+    }
+
+    void UnreservableArena()
+    {
+        auto arena = safetyhook::Allocator::create_arena(module, (std::numeric_limits<std::size_t>::max)() / 2);
+        CHECK(!arena.has_value());
+
+        // What HookBatch::UseArena keeps using when the arena fails
+        auto allocation = safetyhook::Allocator::global()->allocate_near({ module }, 100);
+        CHECK(allocation.has_value() && allocation->size() == 100);
+    }
+}
+
+int main()
+{
+    SlicesAreAlignedAndPacked(64);
+    SlicesAreAlignedAndPacked(256);
+    FullArenaFallsBack();
+    UnreservableArena();
+    return Test::Finish("allocator_test");
+}
@@ -0,0 +1,185 @@
+// Checks the signature cache against a synthetic module: a warm cache verifies every signature in
+// place, a different TimeDateStamp or SizeOfImage never reuses an RVA, and an RVA that no longer
+// matches fails to seed and is replaced by the scan result or erased.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\cache_test.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/cache_test.cpp -o cache_test
+
+#include "cache.hpp"
+#include "check.hpp"
+#include "scanner.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint32_t Timestamp = 0x4F5A1234;
+    constexpr std::uint32_t SizeOfImage = 0x10000;
+
+    struct Signature
+    {
+        const char* name;
+        const char* pattern;
+        const char* section;
+        std::vector<std::uint8_t> bytes;
+        std::uint32_t rva;
+    };
+
+    std::vector<Signature> Signatures = {
+        { "Code1", "F3 0F 59 ?? ?? ?? ?? 00 E8", "", { 0xF3, 0x0F, 0x59, 0x05, 0x10, 0x20, 0x30, 0x00, 0xE8 }, 0x2345 },
+        { "Code2", "8B ?? 08 89 ?? 3B ?? 75", "", { 0x8B, 0x4C, 0x08, 0x89, 0x0D, 0x3B, 0xC1, 0x75 }, 0x6000 },
+        { "Data", "00 00 34 44 00 00 B4 43", ".rdata", { 0x00, 0x00, 0x34, 0x44, 0x00, 0x00, 0xB4, 0x43 }, 0xA010 },
+    };
+
+    // Code and data filled with int3 so nothing matches by accident
+    struct Module
+    {
+        std::vector<std::uint8_t> image = std::vector<std::uint8_t>(SizeOfImage, 0xCC);
+        std::vector<Scanner::Region> regions;
+
+        Module()
+        {
+            regions.push_back({ ".text", image.data() + 0x1000, 0x8000, true });
+            regions.push_back({ ".rdata", image.data() + 0x9000, 0x4000, false });
+            for (const auto& signature : Signatures)
+                Place(signature, signature.rva);
+        }
+
+        void Place(const Signature& signature, std::uint32_t rva)
+        {
+            std::memcpy(image.data() + rva, signature.bytes.data(), signature.bytes.size());
+        }
+
+        void Remove(const Signature& signature, std::uint32_t rva)
+        {
+            std::memset(image.data() + rva, 0xCC, signature.bytes.size());
+        }
+    };
+
+    std::uint64_t Key(const Signature& signature)
+    {
+        return Scanner::Hash(Scanner::Pattern(signature.pattern), signature.section);
+    }
+
+    Scanner::Batch Batch()
+    {
+        Scanner::Batch batch;
+        for (const auto& signature : Signatures)
+            batch.Add(signature.name, Scanner::Pattern(signature.pattern), signature.section);
+        return batch;
+    }
+
+    std::size_t Run(const Module& module, Scanner::Cache& cache, Scanner::Batch& batch)
+    {
+        return Scanner::ScanCached(module.image.data(), module.regions, batch, cache);
+    }
+
+    bool AllFound(const Module& module, const Scanner::Batch& batch)
+    {
+        for (const auto& signature : Signatures) {
+            if (batch.Get(signature.name) != module.image.data() + signature.rva)
+                return false;
+        }
+        return true;
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "dddafix_cache_test.txt";
+
+    // A cold scan fills the cache and the next launch of the same build verifies every RVA in place
+    void WarmCache()
+    {
+        Module module;
+        Scanner::Cache cold(Timestamp, SizeOfImage);
+        auto batch = Batch();
+        CHECK(Run(module, cold, batch) == 0);
+        CHECK(AllFound(module, batch));
+        CHECK(cold.Dirty());
+        CHECK(cold.Save(path));
+
+        Scanner::Cache warm(Timestamp, SizeOfImage);
+        CHECK(warm.Load(path));
+        batch = Batch();
+        CHECK(Run(module, warm, batch) == Signatures.size());
+        CHECK(AllFound(module, batch));
+        CHECK(!warm.Dirty());
+    }
+
+    // Another build must scan again even though its signatures sit at the same RVAs, and saving it keeps
+    // the first build's entries
+    void OtherBuild(std::uint32_t timestamp, std::uint32_t sizeOfImage)
+    {
+        Module module;
+        Scanner::Cache other(timestamp, sizeOfImage);
+        CHECK(other.Load(path));
+        for (const auto& signature : Signatures)
+            CHECK(!other.Find(Key(signature)));
+
+        auto batch = Batch();
+        CHECK(Run(module, other, batch) == 0);
+        CHECK(AllFound(module, batch));
+        CHECK(other.Dirty());
+        CHECK(other.Save(path));
+
+        Scanner::Cache original(Timestamp, SizeOfImage);
+        CHECK(original.Load(path));
+        batch = Batch();
+        CHECK(Run(module, original, batch) == Signatures.size());
+    }
+
+    // A moved signature fails to seed at its old RVA and the scan result replaces the entry
+    void MovedSignature()
+    {
+        Module module;
+        const auto& moved = Signatures[0];
+        module.Remove(moved, moved.rva);
+        module.Place(moved, 0x3000);
+
+        Scanner::Cache cache(Timestamp, SizeOfImage);
+        CHECK(cache.Load(path));
+        CHECK(cache.Find(Key(moved)) == moved.rva);
+
+        auto batch = Batch();
+        CHECK(!batch.Seed(moved.name, module.image.data() + moved.rva, module.regions));
+        CHECK(Run(module, cache, batch) == Signatures.size() - 1);
+        CHECK(batch.Get(moved.name) == module.image.data() + 0x3000);
+        CHECK(cache.Find(Key(moved)) == 0x3000u);
+        CHECK(cache.Dirty());
+    }
+
+    // A signature that is gone has its entry erased, including from the saved file
+    void MissingSignature()
+    {
+        Module module;
+        const auto& missing = Signatures[2];
+        module.Remove(missing, missing.rva);
+
+        Scanner::Cache cache(Timestamp, SizeOfImage);
+        CHECK(cache.Load(path));
+        CHECK(cache.Find(Key(missing)));
+
+        auto batch = Batch();
+        CHECK(Run(module, cache, batch) == Signatures.size() - 1);
+        CHECK(!batch.Get(missing.name));
+        CHECK(!cache.Find(Key(missing)));
+        CHECK(cache.Dirty());
+        CHECK(cache.Save(path));
+
+        Scanner::Cache reloaded(Timestamp, SizeOfImage);
+        CHECK(reloaded.Load(path));
+        CHECK(!reloaded.Find(Key(missing)));
+        CHECK(reloaded.Find(Key(Signatures[1])) == Signatures[1].rva);
+    }
+}
+
+int main()
+{
+    WarmCache();
+    OtherBuild(Timestamp + 1, SizeOfImage);
+    OtherBuild(Timestamp, SizeOfImage + 0x1000);
+    MovedSignature();
+    MissingSignature();
+    std::filesystem::remove(path);
+    return Test::Finish("cache_test");
+}
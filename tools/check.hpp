@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+
+// Assertions for the tests in this directory. Each test is a plain executable that prints the
+// checks that failed and exits with 1 if there were any.
+namespace Test
+{
+    inline int failures = 0;
+
+    inline bool Check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition) {
+            ++failures;
+            std::printf("%s:%d: CHECK(%s) failed\n", file, line, expression);
+        }
+        return condition;
+    }
+
+    inline int Finish(const char* name)
+    {
+        std::printf("%s: %s\n", name, failures ? "FAILED" : "passed");
+        return failures ? 1 : 0;
+    }
+}
+
+#define CHECK(condition) Test::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
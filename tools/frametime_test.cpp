@@ -0,0 +1,191 @@
+// Checks frame time capture against hand-computed streams: Recorder::Drain accounts for every
+// timestamp as delivered or lost on overruns and laps, FrameTimes converts ticks to milliseconds,
+// and Analyse gets percentiles, 1% and 0.1% lows and stutter counts right.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\frametime_test.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/frametime_test.cpp -o frametime_test
+
+#include "check.hpp"
+#include "frametime.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    bool Near(double value, double expected)
+    {
+        return std::fabs(value - expected) <= 1e-9 * (std::max)(1.0, std::fabs(expected));
+    }
+
+    std::vector<std::int64_t> Range(std::int64_t first, std::int64_t last)
+    {
+        std::vector<std::int64_t> values;
+        for (auto value = first; value <= last; ++value)
+            values.push_back(value);
+        return values;
+    }
+
+    void Push(FrameTime::Recorder<8>& recorder, std::int64_t first, std::int64_t last)
+    {
+        for (auto value = first; value <= last; ++value)
+            recorder.Push(value);
+    }
+
+    void DrainAccounting()
+    {
+        FrameTime::Recorder<8> recorder;
+        std::vector<std::int64_t> out;
+
+        // Less than a ring behind, everything arrives
+        Push(recorder, 1, 5);
+        CHECK(recorder.Drain(out) == 0);
+        CHECK(out == Range(1, 5));
+
+        // Nothing new, nothing lost
+        out.clear();
+        CHECK(recorder.Drain(out) == 0);
+        CHECK(out.empty());
+
+        // 15 behind on a ring of 8: 7 were overwritten before the drain, and the oldest of the 8 left
+        // is dropped too since the push after them could be overwriting it
+        Push(recorder, 6, 20);
+        out = { -1 };
+        CHECK(recorder.Drain(out) == 8);
+        auto expected = Range(14, 20);
+        expected.insert(expected.begin(), -1);
+        CHECK(out == expected);
+
+        // Exactly a full ring behind is still a lap for the slot of the next push
+        out.clear();
+        Push(recorder, 21, 28);
+        CHECK(recorder.Drain(out) == 1);
+        CHECK(out == Range(22, 28));
+
+        // One short of a full ring is safe
+        out.clear();
+        Push(recorder, 29, 35);
+        CHECK(recorder.Drain(out) == 0);
+        CHECK(out == Range(29, 35));
+    }
+
+    // A producer pushing 1, 2, 3, ... as fast as it can against a slow consumer. Whatever arrives
+    // must be in order with no stale slot from an earlier lap, and delivered plus lost must add up
+    // to every push.
+    void ConcurrentLaps()
+    {
+        constexpr std::int64_t Pushes = 2000000;
+        FrameTime::Recorder<8> recorder;
+        std::atomic<bool> done{ false };
+        std::thread producer([&] {
+            for (std::int64_t value = 1; value <= Pushes; ++value)
+                recorder.Push(value);
+            done = true;
+        });
+
+        std::vector<std::int64_t> out;
+        std::uint64_t lost = 0;
+        std::int64_t last = 0;
+        std::size_t outOfOrder = 0;
+        auto consume = [&] {
+            out.clear();
+            lost += recorder.Drain(out);
+            for (auto value : out) {
+                outOfOrder += value <= last;
+                last = value;
+            }
+            return out.size();
+        };
+
+        std::uint64_t delivered = 0;
+        while (!done)
+            delivered += consume();
+        producer.join();
+        delivered += consume();
+
+        CHECK(outOfOrder == 0);
+        CHECK(last == Pushes);
+        CHECK(delivered + lost == Pushes);
+    }
+
+    void FrameTimesFromTicks()
+    {
+        // 100 kHz ticks: 10 ms, 20 ms, 5 ms
+        auto frameTimes = FrameTime::FrameTimes({ 0, 1000, 3000, 3500 }, 100000);
+        CHECK(frameTimes == std::vector<double>({ 10.0, 20.0, 5.0 }));
+
+        CHECK(FrameTime::FrameTimes({ 0, 1000 }, 1000) == std::vector<double>({ 1000.0 }));
+        CHECK(FrameTime::FrameTimes({ 1000 }, 100000).empty());
+        CHECK(FrameTime::FrameTimes({}, 100000).empty());
+        CHECK(FrameTime::FrameTimes({ 0, 1000 }, 0).empty());
+    }
+
+    void AnalyseSmall()
+    {
+        // Sorted 5, 10, 20, 40: nearest rank of 50% is the 2nd, 90% and up the 4th, and 1% of four frames
+        // still averages the single slowest one
+        auto stats = FrameTime::Analyse({ 10, 20, 5, 40 });
+        CHECK(stats.frames == 4);
+        CHECK(Near(stats.averageMs, 18.75));
+        CHECK(Near(stats.averageFps, 1000.0 / 18.75));
+        CHECK(stats.p50Ms == 10);
+        CHECK(stats.p90Ms == 40);
+        CHECK(stats.p99Ms == 40);
+        CHECK(stats.p999Ms == 40);
+        CHECK(stats.maxMs == 40);
+        CHECK(Near(stats.low1Fps, 25));
+        CHECK(Near(stats.low01Fps, 25));
+        CHECK(stats.stutters == 1);
+
+        // Twice the median is 20, which doesn't count
+        CHECK(FrameTime::Analyse({ 10, 20, 5, 40 }, 2.0).stutters == 1);
+        CHECK(FrameTime::Analyse({ 10, 20, 5, 40 }, 1.5).stutters == 2);
+
+        // Ranks round up: 90% of seven frames is 6.3, so the 7th
+        auto seven = FrameTime::Analyse({ 4, 7, 1, 6, 2, 5, 3 });
+        CHECK(seven.p50Ms == 4);
+        CHECK(seven.p90Ms == 7);
+        CHECK(seven.p99Ms == 7);
+
+        auto empty = FrameTime::Analyse({});
+        CHECK(empty.frames == 0 && empty.averageMs == 0 && empty.p99Ms == 0 && empty.stutters == 0);
+    }
+
+    void AnalyseThousand()
+    {
+        // 990 frames of 10 ms, 9 of 25 ms and one of 100 ms, the slow ones spread through the stream
+        std::vector<double> frameTimes(1000, 10.0);
+        for (std::size_t i = 0; i < 9; ++i)
+            frameTimes[50 + i * 100] = 25.0;
+        frameTimes[500] = 100.0;
+
+        auto stats = FrameTime::Analyse(frameTimes);
+        CHECK(stats.frames == 1000);
+        CHECK(Near(stats.averageMs, 10.225));
+        CHECK(Near(stats.averageFps, 1000.0 / 10.225));
+        CHECK(stats.p50Ms == 10);
+        CHECK(stats.p90Ms == 10);
+        CHECK(stats.p99Ms == 10);      // 990th of 1000
+        CHECK(stats.p999Ms == 25);     // 999th
+        CHECK(stats.maxMs == 100);
+        CHECK(Near(stats.low1Fps, 1000.0 / 32.5));    // (9 * 25 + 100) / 10
+        CHECK(Near(stats.low01Fps, 10));              // The 100 ms frame alone
+        CHECK(stats.stutters == 10);
+
+        CHECK(FrameTime::Analyse(frameTimes, 3.0).stutters == 1);
+        CHECK(FrameTime::Analyse(frameTimes, 10.0).stutters == 0);
+    }
+}
+
+int main()
+{
+    DrainAccounting();
+    ConcurrentLaps();
+    FrameTimesFromTicks();
+    AnalyseSmall();
+    AnalyseThousand();
+    return Test::Finish("frametime_test");
+}
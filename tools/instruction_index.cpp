@@ -0,0 +1,111 @@
+// Builds the instruction index over a game executable on disk and compares lookups by instruction
+// sequence with byte signature scans. Without sequences on the command line, every signature in
+// src/signatures.hpp is turned into the instruction sequence at its match and looked up both ways,
+// which is also how a byte signature is converted to an instruction one.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src /I external\safetyhook tools\instruction_index.cpp external\safetyhook\Zydis.c
+//   gcc -O2 -c external/safetyhook/Zydis.c -o Zydis.o
+//   g++ -std=c++20 -O2 -I src -I external/safetyhook tools/instruction_index.cpp Zydis.o -o instruction_index
+// Usage: instruction_index <DDDA.exe> ["movss xmm, abs; mulss xmm, mem; ..."]...
+
+#include "instructions.hpp"
+#include "pe.hpp"
+#include "scanner.hpp"
+#include "signatures.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::printf("Usage: %s <DDDA.exe> [sequence]...\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto image = PE::Parse(bytes.data(), bytes.size());
+    auto mapped = PE::Map(bytes.data(), bytes.size());
+    if (!file || !image || !mapped) {
+        std::printf("%s is not a readable PE file\n", argv[1]);
+        return 2;
+    }
+
+    std::vector<Scanner::Region> regions;
+    for (const auto& section : image->sections) {
+        auto [offset, size] = image->Extent(section);
+        if (size)
+            regions.push_back({ section.name, mapped->data() + offset, size, section.IsExecutable() });
+    }
+    if (std::none_of(regions.begin(), regions.end(), [](const Scanner::Region& region) { return region.executable; }))
+        regions.push_back({ {}, mapped->data(), mapped->size(), true });
+
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+    auto rva = [&](const std::uint8_t* address) { return static_cast<std::uint32_t>(address - mapped->data()); };
+
+    Instructions::Index index;
+    auto buildStart = Clock::now();
+    if (!index.Build(regions)) {
+        std::printf("Failed to initialize the decoder\n");
+        return 2;
+    }
+    std::printf("Index: %zu instructions in %.2fms\n\n", index.Size(), elapsed(buildStart));
+
+    if (argc > 2) {
+        int failures = 0;
+        for (int i = 2; i < argc; ++i) {
+            auto sequence = Instructions::Parse(argv[i]);
+            if (!sequence || sequence->size() < Instructions::Index::K) {
+                std::printf("%s: needs at least %zu known instructions\n", argv[i], Instructions::Index::K);
+                ++failures;
+                continue;
+            }
+
+            auto start = Clock::now();
+            auto matches = index.Find(*sequence);
+            auto time = elapsed(start);
+            std::printf("%s: %zu matches in %.3fms\n", Instructions::Format(*sequence).c_str(), matches.size(), time);
+            for (auto match : matches)
+                std::printf("  0x%08X\n", rva(match));
+            failures += matches.size() != 1;
+        }
+        return failures ? 1 : 0;
+    }
+
+    // Each signature's match as an instruction sequence covering the same bytes, looked up both ways
+    double scanTotal = 0;
+    double lookupTotal = 0;
+    std::printf("%-24s %-10s %-8s %-10s %-10s %s\n", "Signature", "Match", "Count", "Scan", "Lookup", "Instructions");
+    for (const auto& signature : GameSignatures::All) {
+        Scanner::Pattern pattern(signature.signature);
+
+        auto scanStart = Clock::now();
+        auto match = Scanner::Find(regions, pattern, "");
+        auto scanTime = elapsed(scanStart);
+        if (!match) {
+            std::printf("%-24s %-10s\n", signature.name, "-");
+            continue;
+        }
+
+        auto sequence = index.Sequence(match, match + pattern.Size());
+        if (sequence.size() < Instructions::Index::K) {
+            std::printf("%-24s 0x%08X %-8s %.3fms    %-10s (not enough decoded instructions at the match)\n", signature.name, rva(match), "-", scanTime, "-");
+            continue;
+        }
+
+        auto lookupStart = Clock::now();
+        auto matches = index.Find(sequence);
+        auto lookupTime = elapsed(lookupStart);
+        scanTotal += scanTime;
+        lookupTotal += lookupTime;
+
+        std::printf("%-24s 0x%08X %-8zu %.3fms    %.3fms    %s\n", signature.name, rva(match), matches.size(), scanTime, lookupTime,
+            Instructions::Format(sequence).c_str());
+    }
+    std::printf("\nTotal: %.2fms scanning bytes, %.2fms looking up instructions\n", scanTotal, lookupTotal);
+    return 0;
+}
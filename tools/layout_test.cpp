@@ -0,0 +1,112 @@
+// Checks Layout::Compute against the formulas the hooks used to evaluate inline, copied from the
+// original dllmain.cpp, over 16:9, 21:9, 32:9, 4:3 and 16:10 resolutions. The HUD, map and
+// marker values must match exactly, since the game sees them as-is.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\layout_test.cpp
+//   g++ -std=c++20 -O2 -I src tools/layout_test.cpp -o layout_test
+
+#include "check.hpp"
+#include "layout.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    // The globals and expressions as the hooks had them before Compute existed
+    float fNativeAspect = (float)16 / 9;
+    float fDefMinimapMulti = 0.0007812500116f;
+
+    struct Inline
+    {
+        float fAspectRatio;
+        float fAspectMultiplier;
+        float fHUDWidth;
+        float fHUDHeight;
+        float fHUDWidthOffset;
+        float fHUDHeightOffset;
+
+        Inline(int iResX, int iResY)
+        {
+            fAspectRatio = (float)iResX / iResY;
+            fAspectMultiplier = fAspectRatio / fNativeAspect;
+
+            fHUDWidth = (float)iResY * fNativeAspect;
+            fHUDHeight = (float)iResY;
+            fHUDWidthOffset = (float)(iResX - fHUDWidth) / 2;
+            fHUDHeightOffset = 0;
+            if (fAspectRatio < fNativeAspect)
+            {
+                fHUDWidth = (float)iResX;
+                fHUDHeight = (float)iResX / fNativeAspect;
+                fHUDWidthOffset = 0;
+                fHUDHeightOffset = (float)(iResY - fHUDHeight) / 2;
+            }
+        }
+    };
+
+    template<typename T>
+    void Same(const char* field, int iResX, int iResY, T computed, T expected)
+    {
+        if (!CHECK(computed == expected))
+            std::printf("  %dx%d %s: %.9g, inline %.9g\n", iResX, iResY, field, static_cast<double>(computed), static_cast<double>(expected));
+    }
+
+    void Check(int iResX, int iResY)
+    {
+        const auto layout = Layout::Compute(iResX, iResY);
+        const Inline old(iResX, iResY);
+
+        Same("fAspectRatio", iResX, iResY, layout.fAspectRatio, old.fAspectRatio);
+        Same("fAspectMultiplier", iResX, iResY, layout.fAspectMultiplier, old.fAspectMultiplier);
+        CHECK((layout.aspect == Layout::Aspect::Wider) == (old.fAspectRatio > fNativeAspect));
+        CHECK((layout.aspect == Layout::Aspect::Narrower) == (old.fAspectRatio < fNativeAspect));
+
+        // HUD
+        Same("fHUDWidth", iResX, iResY, layout.fHUDWidth, old.fHUDWidth);
+        Same("fHUDHeight", iResX, iResY, layout.fHUDHeight, old.fHUDHeight);
+        Same("fHUDWidthOffset", iResX, iResY, layout.fHUDWidthOffset, old.fHUDWidthOffset);
+        Same("fHUDHeightOffset", iResX, iResY, layout.fHUDHeightOffset, old.fHUDHeightOffset);
+        Same("iHUDWidth", iResX, iResY, layout.iHUDWidth, (int)old.fHUDWidth);
+        Same("iHUDWidthOffset", iResX, iResY, layout.iHUDWidthOffset, (int)old.fHUDWidthOffset);
+        Same("fCanvasWidth", iResX, iResY, layout.fCanvasWidth, (float)720 * old.fAspectRatio);
+        Same("fCanvasHeight", iResX, iResY, layout.fCanvasHeight, (float)1280 / old.fAspectRatio);
+        Same("fCanvasWidthOffset", iResX, iResY, layout.fCanvasWidthOffset, (float)((720 * old.fAspectRatio) - 1280) / 2);
+        Same("fCanvasHeightOffset", iResX, iResY, layout.fCanvasHeightOffset, (float)((1280 / old.fAspectRatio) - 720) / 2);
+        Same("fInverseAspectMultiplier", iResX, iResY, layout.fInverseAspectMultiplier, (float)1 / old.fAspectMultiplier);
+        Same("fInverseAspectRatio", iResX, iResY, layout.fInverseAspectRatio, (float)iResY / iResX);
+
+        // Minimap and map
+        Same("fMinimapSize", iResX, iResY, layout.fMinimapSize, (float)iResX * fDefMinimapMulti);
+        Same("fMapAreaSize", iResX, iResY, layout.fMapAreaSize, (float)old.fHUDWidth * fDefMinimapMulti);
+        Same("fMapAreaMulti", iResX, iResY, layout.fMapAreaMulti, fDefMinimapMulti / old.fAspectMultiplier);
+        Same("fMapCursorWidth", iResX, iResY, layout.fMapCursorWidth, (float)iResX / old.fAspectMultiplier);
+        Same("iMapAreaWidth", iResX, iResY, layout.iMapAreaWidth, old.fAspectRatio > fNativeAspect ? (int)old.fHUDWidth : iResX);
+
+        // Quest, pawn and player markers
+        int iOrigMinimapWidthOffset = (int)floorf((((iResX * fDefMinimapMulti) * 256) / 2) + ((iResX * fDefMinimapMulti) * 40));
+        int iOrigMinimapHeightOffset = (int)floorf(((iResX / (float)1280) * 454) + (((iResX * fDefMinimapMulti) * 256) / 2) + (iResY - old.fHUDHeight) / 2);
+        Same("iMinimapWidthOffset", iResX, iResY, layout.iMinimapWidthOffset, (int)floorf(iOrigMinimapWidthOffset / old.fAspectMultiplier));
+        Same("iMinimapRingWidthOffset", iResX, iResY, layout.iMinimapRingWidthOffset, (int)floorf((iOrigMinimapWidthOffset / old.fAspectMultiplier) + old.fHUDWidthOffset));
+        Same("iMinimapHeightOffset", iResX, iResY, layout.iMinimapHeightOffset, iOrigMinimapHeightOffset);
+        Same("iMinimapMarkerHeightOffset", iResX, iResY, layout.iMinimapMarkerHeightOffset, (int)floorf(iOrigMinimapHeightOffset - ((iResY - old.fHUDHeight) / 2)));
+    }
+}
+
+int main()
+{
+    const int resolutions[][2] = {
+        { 1280, 720 }, { 1366, 768 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 },  // 16:9, 1366 is slightly wider
+        { 2560, 1080 }, { 3440, 1440 }, { 5120, 2160 },                                 // 21:9
+        { 3840, 1080 }, { 5120, 1440 },                                                 // 32:9
+        { 800, 600 }, { 1024, 768 }, { 1600, 1200 },                                    // 4:3
+        { 1280, 800 }, { 1680, 1050 }, { 1920, 1200 }, { 2560, 1600 },                  // 16:10
+    };
+    for (const auto& resolution : resolutions)
+        Check(resolution[0], resolution[1]);
+
+    CHECK(Layout::Compute(1920, 1080).aspect == Layout::Aspect::Native);
+    CHECK(Layout::Compute(3440, 1440).aspect == Layout::Aspect::Wider);
+    CHECK(Layout::Compute(1920, 1200).aspect == Layout::Aspect::Narrower);
+    return Test::Finish("layout_test");
+}
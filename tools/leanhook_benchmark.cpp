@@ -0,0 +1,78 @@
+// Measures the cost per call of a safetyhook mid hook against a LeanHook stub on the same target.
+// x86 only. Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src /I external\safetyhook tools\leanhook_benchmark.cpp external\safetyhook\safetyhook.cpp external\safetyhook\Zydis.c
+//   gcc -m32 -O2 -c external/safetyhook/Zydis.c -o Zydis.o
+//   g++ -m32 -std=c++23 -O2 -I src -I external/safetyhook tools/leanhook_benchmark.cpp external/safetyhook/safetyhook.cpp Zydis.o -o leanhook_benchmark
+// Usage: leanhook_benchmark [calls]
+
+#include "leanhook.hpp"
+
+#include <safetyhook.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define NOINLINE __declspec(noinline)
+#else
+#include <x86intrin.h>
+#define NOINLINE __attribute__((noinline))
+#endif
+
+volatile int sink;
+
+// Something with enough instructions ahead of the return to hold a jmp
+NOINLINE int Target(int value)
+{
+    sink = value;
+    return value * 3 + sink;
+}
+
+// Called through a volatile pointer so the compiler can't inline or clone it behind the hook's back
+int (*volatile CallTarget)(int) = &Target;
+int calls;
+
+int main(int argc, char** argv)
+{
+    int count = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    // Best of several runs, the minimum is the least disturbed by interrupts and migrations
+    auto measure = [&] {
+        auto best = ~0ull;
+        for (int run = 0; run < 10; ++run) {
+            auto start = __rdtsc();
+            for (int i = 0; i < count; ++i)
+                CallTarget(i);
+            best = (std::min)(best, __rdtsc() - start);
+        }
+        return static_cast<double>(best) / count;
+    };
+
+    auto baseline = measure();
+    std::printf("unhooked     %6.1f cycles/call\n", baseline);
+
+    {
+        auto hook = safetyhook::create_mid(reinterpret_cast<void*>(&Target), [](SafetyHookContext&) { ++calls; });
+        if (!hook) {
+            std::printf("Failed to create the mid hook\n");
+            return 1;
+        }
+        auto cycles = measure();
+        std::printf("full context %6.1f cycles/call (+%.1f)\n", cycles, cycles - baseline);
+    }
+
+    {
+        LeanHook::Hook hook;
+        if (!LeanHook::Hook::Create<LeanHook::Reg::Eax>(hook, safetyhook::Allocator::global(), reinterpret_cast<void*>(&Target),
+                [](auto&) { ++calls; }) || !hook.enable()) {
+            std::printf("Failed to create the lean hook\n");
+            return 1;
+        }
+        auto cycles = measure();
+        std::printf("lean         %6.1f cycles/call (+%.1f)\n", cycles, cycles - baseline);
+    }
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Measures how closely the frame limiter hits its target compared to sleeping straight to the deadline.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\limiter_benchmark.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/limiter_benchmark.cpp -o limiter_benchmark
+// Usage: limiter_benchmark [fps] [frames] [simulated work in ms]
+
+#include "frametime.hpp"
+#include "limiter.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    double fps = argc > 1 ? std::stod(argv[1]) : 141;
+    std::size_t frames = argc > 2 ? std::stoul(argv[2]) : 1000;
+    double work = argc > 3 ? std::stod(argv[3]) : 2.0;
+
+    // Busy work with some jitter so each frame leaves a different amount of time to wait
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<double> jitter(0.5, 1.5);
+    auto simulateFrame = [&] {
+        auto end = Limiter::Now() + static_cast<std::int64_t>(work * jitter(random) * 1000000);
+        while (Limiter::Now() < end) {}
+    };
+
+    auto report = [&](const char* name, const std::vector<std::int64_t>& timestamps) {
+        auto stats = FrameTime::Analyse(FrameTime::FrameTimes(timestamps, 1000000000));
+        auto target = 1000.0 / fps;
+        std::printf("%-8s avg %7.3fms (target %.3fms), p50 %7.3fms, p99 %7.3fms, max %7.3fms, 1%% low %6.1ffps\n",
+            name, stats.averageMs, target, stats.p50Ms, stats.p99Ms, stats.maxMs, stats.low1Fps);
+    };
+
+    // Sleep only: the timer's wake-up latency lands directly in the frame time
+    {
+        Limiter::Sleeper sleeper;
+        auto period = static_cast<std::int64_t>(1000000000.0 / fps);
+        std::vector<std::int64_t> timestamps;
+        std::int64_t deadline = Limiter::Now();
+        for (std::size_t i = 0; i < frames; ++i) {
+            simulateFrame();
+            deadline += period;
+            sleeper.Until(deadline);
+            timestamps.push_back(Limiter::Now());
+        }
+        report("Sleep", timestamps);
+    }
+
+    // Hybrid sleep and calibrated spin
+    {
+        Limiter::FrameLimiter limiter(fps);
+        std::vector<std::int64_t> timestamps;
+        for (std::size_t i = 0; i < frames; ++i) {
+            simulateFrame();
+            limiter.Wait();
+            timestamps.push_back(Limiter::Now());
+        }
+        report("Hybrid", timestamps);
+        std::printf("Spin margin settled at %.3fms\n", limiter.Margin() / 1000000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+// Checks PE::Parse and PE::Map against hand-built PE32 images, well formed and broken: truncated
+// headers, a section table running past the end, zero VirtualSize and sections past SizeOfImage.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\pe_test.cpp
+//   g++ -std=c++20 -O2 -I src tools/pe_test.cpp -o pe_test
+
+#include "check.hpp"
+#include "pe.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t NtOffset = 0x80;
+    constexpr std::size_t FileHeader = NtOffset + 4;
+    constexpr std::size_t OptionalHeader = FileHeader + 20;
+    constexpr std::size_t SectionTable = OptionalHeader + 0xE0;
+    constexpr std::size_t HeaderSize = 0x400;
+
+    struct SectionSpec
+    {
+        const char* name;
+        std::uint32_t virtualAddress;
+        std::uint32_t virtualSize;
+        std::uint32_t sizeOfRawData;
+        std::uint32_t pointerToRawData;
+        std::uint32_t characteristics;
+    };
+
+    template<typename T>
+    void Write(std::vector<std::uint8_t>& file, std::size_t offset, T value)
+    {
+        std::memcpy(file.data() + offset, &value, sizeof(T));
+    }
+
+    // A PE32 file with the given sections, each section's raw data filled with its index + 1
+    std::vector<std::uint8_t> Build(std::uint32_t sizeOfImage, const std::vector<SectionSpec>& sections)
+    {
+        std::size_t fileSize = HeaderSize;
+        for (const auto& section : sections)
+            fileSize = (std::max)(fileSize, static_cast<std::size_t>(section.pointerToRawData) + section.sizeOfRawData);
+
+        std::vector<std::uint8_t> file(fileSize);
+        Write<std::uint16_t>(file, 0, PE::DosSignature);
+        Write<std::uint32_t>(file, 0x3C, NtOffset);
+        Write<std::uint32_t>(file, NtOffset, PE::NtSignature);
+        Write<std::uint16_t>(file, FileHeader, 0x14C);
+        Write<std::uint16_t>(file, FileHeader + 2, static_cast<std::uint16_t>(sections.size()));
+        Write<std::uint32_t>(file, FileHeader + 4, 0x4F5A1234);
+        Write<std::uint16_t>(file, FileHeader + 16, 0xE0);
+        Write<std::uint16_t>(file, OptionalHeader, PE::OptionalMagic32);
+        Write<std::uint32_t>(file, OptionalHeader + 28, 0x400000);
+        Write<std::uint32_t>(file, OptionalHeader + 56, sizeOfImage);
+        Write<std::uint32_t>(file, OptionalHeader + 60, HeaderSize);
+
+        for (std::size_t i = 0; i < sections.size(); ++i) {
+            const auto& section = sections[i];
+            auto header = SectionTable + i * 40;
+            std::memcpy(file.data() + header, section.name, std::strlen(section.name));
+            Write(file, header + 8, section.virtualSize);
+            Write(file, header + 12, section.virtualAddress);
+            Write(file, header + 16, section.sizeOfRawData);
+            Write(file, header + 20, section.pointerToRawData);
+            Write(file, header + 36, section.characteristics);
+            std::fill_n(file.data() + section.pointerToRawData, section.sizeOfRawData, static_cast<std::uint8_t>(i + 1));
+        }
+        return file;
+    }
+
+    constexpr std::uint32_t Code = PE::SectionCode | PE::SectionExecute;
+
+    // Listed out of order, Parse sorts them by address
+    const std::vector<SectionSpec> Sections = {
+        { ".rdata", 0x2000, 0x180, 0x200, 0x600, 0 },
+        { ".text", 0x1000, 0x300, 0x200, 0x400, Code },
+    };
+
+    bool Filled(const std::vector<std::uint8_t>& mapped, std::size_t offset, std::size_t size, std::uint8_t value)
+    {
+        return std::all_of(mapped.begin() + offset, mapped.begin() + offset + size, [&](std::uint8_t byte) { return byte == value; });
+    }
+
+    void ParsesHeaders()
+    {
+        auto file = Build(0x3000, Sections);
+        auto image = PE::Parse(file.data(), file.size());
+        if (!CHECK(image))
+            return;
+
+        CHECK(image->machine == 0x14C);
+        CHECK(image->timestamp == 0x4F5A1234);
+        CHECK(image->imageBase == 0x400000);
+        CHECK(image->sizeOfImage == 0x3000);
+        CHECK(image->sizeOfHeaders == HeaderSize);
+        CHECK(image->sections.size() == 2);
+        CHECK(image->sections[0].name == ".text" && image->sections[0].IsExecutable());
+        CHECK(image->sections[1].name == ".rdata" && !image->sections[1].IsExecutable());
+        CHECK(image->FindSection(".rdata") == &image->sections[1]);
+        CHECK(!image->FindSection(".data"));
+    }
+
+    void MapsSections()
+    {
+        auto file = Build(0x3000, Sections);
+        auto mapped = PE::Map(file.data(), file.size());
+        if (!CHECK(mapped && mapped->size() == 0x3000))
+            return;
+
+        CHECK(std::equal(file.begin(), file.begin() + HeaderSize, mapped->begin()));
+        // Raw data up to the smaller of SizeOfRawData and VirtualSize, zeros after it
+        CHECK(Filled(*mapped, 0x1000, 0x200, 2));
+        CHECK(Filled(*mapped, 0x1200, 0xE00, 0));
+        CHECK(Filled(*mapped, 0x2000, 0x180, 1));
+        CHECK(Filled(*mapped, 0x2180, 0xE80, 0));
+    }
+
+    // Every cut before the end of the section table loses part of the headers
+    void RejectsTruncatedHeaders()
+    {
+        auto file = Build(0x3000, Sections);
+        auto headersEnd = SectionTable + Sections.size() * 40;
+        for (std::size_t size = 0; size < headersEnd; ++size) {
+            if (!CHECK(!PE::Parse(file.data(), size)))
+                break;
+        }
+        CHECK(PE::Parse(file.data(), headersEnd));
+
+        // e_lfanew past the end, and one that wraps around when 24 is added on 32-bit
+        for (std::uint32_t ntOffset : { static_cast<std::uint32_t>(file.size()), 0xFFFFFFF0u }) {
+            auto broken = file;
+            Write<std::uint32_t>(broken, 0x3C, ntOffset);
+            CHECK(!PE::Parse(broken.data(), broken.size()));
+        }
+
+        auto broken = file;
+        Write<std::uint16_t>(broken, OptionalHeader, 0x107);
+        CHECK(!PE::Parse(broken.data(), broken.size()));
+    }
+
+    void RejectsSectionTablePastEnd()
+    {
+        auto file = Build(0x3000, Sections);
+        auto fits = (HeaderSize - SectionTable) / 40;
+        Write<std::uint16_t>(file, FileHeader + 2, static_cast<std::uint16_t>(fits));
+        CHECK(PE::Parse(file.data(), HeaderSize));
+        Write<std::uint16_t>(file, FileHeader + 2, static_cast<std::uint16_t>(fits + 1));
+        CHECK(!PE::Parse(file.data(), HeaderSize));
+        Write<std::uint16_t>(file, FileHeader + 2, 0xFFFF);
+        CHECK(!PE::Parse(file.data(), file.size()));
+        CHECK(!PE::Map(file.data(), file.size()));
+    }
+
+    void ZeroVirtualSizeUsesRawSize()
+    {
+        auto file = Build(0x3000, { { ".text", 0x1000, 0, 0x200, 0x400, Code } });
+        auto image = PE::Parse(file.data(), file.size());
+        auto mapped = PE::Map(file.data(), file.size());
+        if (!CHECK(image && mapped))
+            return;
+
+        auto [offset, size] = image->Extent(image->sections[0]);
+        CHECK(offset == 0x1000 && size == 0x200);
+        CHECK(Filled(*mapped, 0x1000, 0x200, 1));
+        CHECK(Filled(*mapped, 0x1200, 0x1E00, 0));
+    }
+
+    // Sections are clamped to the image, raw data to the file, and nothing is written past either
+    void ClampsSectionsPastSizeOfImage()
+    {
+        auto file = Build(0x3000, {
+            { ".text", 0x1000, 0x1000, 0x1000, 0x400, Code },
+            { ".tail", 0x2800, 0x1000, 0x1000, 0x1400, 0 },
+            { ".gone", 0x5000, 0x1000, 0x200, 0x2400, 0 },
+        });
+        auto image = PE::Parse(file.data(), file.size());
+        if (!CHECK(image && image->sections.size() == 3))
+            return;
+
+        auto [tailOffset, tailSize] = image->Extent(image->sections[1]);
+        CHECK(tailOffset == 0x2800 && tailSize == 0x800);
+        auto [goneOffset, goneSize] = image->Extent(image->sections[2]);
+        CHECK(goneOffset == 0x3000 && goneSize == 0);
+
+        auto mapped = PE::Map(file.data(), file.size());
+        if (!CHECK(mapped && mapped->size() == 0x3000))
+            return;
+        CHECK(Filled(*mapped, 0x1000, 0x1000, 1));
+        CHECK(Filled(*mapped, 0x2000, 0x800, 0));
+        CHECK(Filled(*mapped, 0x2800, 0x800, 2));
+
+        // Raw data cut short by the end of the file
+        auto cut = file;
+        cut.resize(0x1400 + 0x100);
+        mapped = PE::Map(cut.data(), cut.size());
+        if (!CHECK(mapped))
+            return;
+        CHECK(Filled(*mapped, 0x2800, 0x100, 2));
+        CHECK(Filled(*mapped, 0x2900, 0x700, 0));
+    }
+
+    void RejectsEmptyImage()
+    {
+        auto file = Build(0, Sections);
+        CHECK(PE::Parse(file.data(), file.size()));
+        CHECK(!PE::Map(file.data(), file.size()));
+    }
+}
+
+int main()
+{
+    ParsesHeaders();
+    MapsSections();
+    RejectsTruncatedHeaders();
+    RejectsSectionTablePastEnd();
+    ZeroVirtualSizeUsesRawSize();
+    ClampsSectionsPastSizeOfImage();
+    RejectsEmptyImage();
+    return Test::Finish("pe_test");
+}
@@ -0,0 +1,163 @@
+// Checks every scan kernel and the batch scanner against the scalar reference, including unaligned
+// buffers, sizes that don't fill a vector and patterns in the last 31 bytes of a buffer.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\scanner_test.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/scanner_test.cpp -o scanner_test
+
+#include "check.hpp"
+#include "scanner.hpp"
+
+#include <random>
+#include <string>
+
+namespace
+{
+    std::mt19937 random(42);
+
+    // Bytes with roughly the distribution of x86 code so anchors hit as often as they do in the game
+    std::vector<std::uint8_t> Code(std::size_t size)
+    {
+        std::discrete_distribution<int> bytes(Scanner::ByteFrequency.begin(), Scanner::ByteFrequency.end());
+        std::vector<std::uint8_t> code(size);
+        for (auto& byte : code)
+            byte = static_cast<std::uint8_t>(bytes(random));
+        return code;
+    }
+
+    // A pattern cut from data at offset with some bytes wildcarded, optionally changed so it can't match there
+    Scanner::Pattern Cut(const std::uint8_t* data, std::size_t length, bool corrupt)
+    {
+        std::vector<int> bytes(data, data + length);
+        for (auto& byte : bytes) {
+            if (random() % 4 == 0)
+                byte = -1;
+        }
+        if (corrupt) {
+            auto& byte = bytes[random() % length];
+            byte = byte == -1 ? 0x5A : (byte ^ 0xA5);
+        }
+        return Scanner::Pattern(bytes);
+    }
+
+    std::vector<Scanner::Kernel> Kernels()
+    {
+        std::vector<Scanner::Kernel> kernels = { Scanner::Kernel::Scalar };
+#if SCANNER_X86
+        kernels.push_back(Scanner::Kernel::SSE2);
+        if (Scanner::HasAVX2())
+            kernels.push_back(Scanner::Kernel::AVX2);
+#endif
+        return kernels;
+    }
+
+    void FindMatchesScalar()
+    {
+        auto code = Code(4096 + 64);
+        for (int round = 0; round < 20000; ++round) {
+            // Unaligned start and a size that rarely fills the last vector
+            auto shift = random() % 32;
+            auto size = 1 + random() % (round % 4 == 0 ? 4096 : 300);
+            auto data = code.data() + shift;
+            auto length = 1 + random() % (std::min<std::size_t>)(size, 70);
+
+            // Mostly from the last 31 bytes, where the vector loops hand over to the tail
+            std::size_t offset;
+            if (round % 2 && size >= length + 31)
+                offset = size - length - random() % 32;
+            else
+                offset = random() % (size - length + 1);
+            if (offset + length > size)
+                offset = size - length;
+
+            auto pattern = Cut(data + offset, length, round % 5 == 0);
+            auto expected = Scanner::FindScalar(data, size, pattern);
+            for (auto kernel : Kernels()) {
+                if (!CHECK(Scanner::Find(data, size, pattern, kernel) == expected)) {
+                    std::printf("  kernel %s, size %zu, shift %zu, length %zu, offset %zu\n", Scanner::KernelName(kernel), size, shift, length, offset);
+                    return;
+                }
+            }
+        }
+    }
+
+    void AnchorSetMatchesScalar()
+    {
+        auto code = Code(1000);
+        for (int round = 0; round < 2000; ++round) {
+            Scanner::AnchorSet set;
+            set.Clear();
+            auto count = 1 + random() % 40;
+            for (std::size_t i = 0; i < count; ++i)
+                set.Insert(static_cast<std::uint8_t>(random()));
+
+            auto begin = random() % 64;
+            auto end = begin + random() % (code.size() - begin);
+            std::vector<std::size_t> expected;
+            for (auto i = begin; i < end; ++i) {
+                if (set.Contains(code[i]))
+                    expected.push_back(i);
+            }
+
+            for (auto kernel : Kernels()) {
+                std::vector<std::size_t> visited;
+                set.ForEach(code.data(), begin, end, kernel, [&](std::size_t i) { visited.push_back(i); return true; });
+                if (!CHECK(visited == expected)) {
+                    std::printf("  kernel %s, %zu bytes in the set, range [%zu, %zu)\n", Scanner::KernelName(kernel), count, begin, end);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Several chunks per thread, matches planted more than once so the lowest has to win
+    void BatchMatchesScalar()
+    {
+        auto code = Code(3 << 20);
+        std::vector<Scanner::Pattern> patterns;
+        for (int i = 0; i < 64; ++i) {
+            auto length = 8 + random() % 40;
+            auto offset = i % 8 == 0 ? code.size() - length - random() % 32 : random() % (code.size() - length);
+            auto pattern = Cut(code.data() + offset, length, i % 7 == 0);
+            if (i % 3 == 0) {
+                auto copy = random() % (code.size() - length);
+                for (std::size_t j = 0; j < length; ++j) {
+                    if (pattern.mask[j])
+                        code[copy + j] = pattern.value[j];
+                }
+            }
+            patterns.push_back(std::move(pattern));
+        }
+
+        // Two regions, the second one searched only by section name
+        std::vector<Scanner::Region> regions = {
+            { ".text", code.data(), code.size() - (1 << 20), true },
+            { ".rdata", code.data() + code.size() - (1 << 20), 1 << 20, false },
+        };
+
+        std::vector<const std::uint8_t*> expected;
+        for (std::size_t i = 0; i < patterns.size(); ++i)
+            expected.push_back(Scanner::Find(regions, patterns[i], i % 4 == 0 ? ".rdata" : ""));
+
+        for (auto kernel : Kernels()) {
+            for (unsigned threads : { 1u, 3u, 8u }) {
+                Scanner::Batch batch;
+                for (std::size_t i = 0; i < patterns.size(); ++i)
+                    batch.Add(std::to_string(i), patterns[i], i % 4 == 0 ? ".rdata" : "");
+                batch.Scan(regions, threads, kernel);
+
+                for (std::size_t i = 0; i < patterns.size(); ++i) {
+                    if (!CHECK(batch.Get(std::to_string(i)) == expected[i]))
+                        std::printf("  kernel %s, %u threads, signature %zu\n", Scanner::KernelName(kernel), threads, i);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    FindMatchesScalar();
+    AnchorSetMatchesScalar();
+    BatchMatchesScalar();
+    return Test::Finish("scanner_test");
+}
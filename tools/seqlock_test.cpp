@@ -0,0 +1,131 @@
+// Hammers SeqLock with writers and readers running at once and fails on any torn read: a value
+// that is a mix of two stores, or one that goes back in time for a reader of a single writer.
+// Also runs the real LayoutState switching between two resolutions, the way a reload does.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\seqlock_test.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/seqlock_test.cpp -o seqlock_test
+
+#include "check.hpp"
+#include "layout.hpp"
+#include "seqlock.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int Readers = 3;
+    constexpr std::uint32_t Stores = 200000;
+
+    // Same number of words as LayoutState carries, every word holds the store's stamp
+    struct Stamp
+    {
+        std::uint32_t words[31];
+    };
+
+    Stamp Make(std::uint32_t stamp)
+    {
+        Stamp value;
+        for (auto& word : value.words)
+            word = stamp;
+        return value;
+    }
+
+    bool Uniform(const Stamp& value)
+    {
+        for (auto word : value.words) {
+            if (word != value.words[0])
+                return false;
+        }
+        return true;
+    }
+
+    // Runs writers until they are done and readers alongside them, returns the torn reads seen
+    template<typename Write, typename Read>
+    int Stress(int writers, Write&& write, Read&& read)
+    {
+        std::atomic<int> writing{ writers };
+        std::atomic<int> torn{ 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < Readers; ++i) {
+            threads.emplace_back([&] {
+                int local = 0;
+                std::uint32_t last = 0;
+                std::uint64_t reads = 0;
+                while (writing.load(std::memory_order_relaxed) || reads == 0) {
+                    local += !read(last);
+                    ++reads;
+                }
+                torn += local;
+            });
+        }
+        for (int i = 0; i < writers; ++i) {
+            threads.emplace_back([&, i] {
+                write(i);
+                --writing;
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        return torn;
+    }
+
+    void SingleWriter()
+    {
+        SeqLock<Stamp> lock(Make(0));
+        auto torn = Stress(1,
+            [&](int) {
+                for (std::uint32_t i = 1; i <= Stores; ++i)
+                    lock.Store(Make(i));
+            },
+            [&](std::uint32_t& last) {
+                auto value = lock.Load();
+                auto ok = Uniform(value) && value.words[0] >= last;
+                last = value.words[0];
+                return ok;
+            });
+        CHECK(torn == 0);
+        CHECK(lock.Load().words[0] == Stores);
+    }
+
+    // Writers are serialised on the sequence, so a reader still never sees two stores mixed
+    void ConcurrentWriters()
+    {
+        SeqLock<Stamp> lock(Make(0));
+        auto torn = Stress(2,
+            [&](int writer) {
+                for (std::uint32_t i = 1; i <= Stores; ++i)
+                    lock.Store(Make(i * 2 + writer));
+            },
+            [&](std::uint32_t&) { return Uniform(lock.Load()); });
+        CHECK(torn == 0);
+        CHECK(lock.Load().words[0] / 2 == Stores);
+    }
+
+    void LayoutSwitch()
+    {
+        const auto wide = Layout::Compute(3440, 1440);
+        const auto narrow = Layout::Compute(1280, 1024);
+        SeqLock<Layout::LayoutState> lock(wide);
+        auto torn = Stress(1,
+            [&](int) {
+                for (std::uint32_t i = 0; i < Stores; ++i)
+                    lock.Store(i & 1 ? wide : narrow);
+            },
+            [&](std::uint32_t&) {
+                auto layout = lock.Load();
+                return std::memcmp(&layout, &wide, sizeof(layout)) == 0 || std::memcmp(&layout, &narrow, sizeof(layout)) == 0;
+            });
+        CHECK(torn == 0);
+    }
+}
+
+int main()
+{
+    SingleWriter();
+    ConcurrentWriters();
+    LayoutSwitch();
+    return Test::Finish("seqlock_test");
+}
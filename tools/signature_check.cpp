@@ -0,0 +1,118 @@
+// Resolves every signature in src/signatures.hpp against a game executable on disk, so a new build
+// can be checked and the scanner profiled without launching the game.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src tools\signature_check.cpp
+//   g++ -std=c++20 -O2 -pthread -I src tools/signature_check.cpp -o signature_check
+// Usage: signature_check <DDDA.exe> [threads]
+// Exits with 1 if any signature is missing, matches more than once or has a target outside the
+// image, 2 if the file can't be read.
+
+#include "pe.hpp"
+#include "resolve.hpp"
+#include "scanner.hpp"
+#include "signatures.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::printf("Usage: %s <DDDA.exe> [threads]\n", argv[0]);
+        return 2;
+    }
+    unsigned threads = argc > 2 ? std::stoul(argv[2]) : (std::max)(1u, std::thread::hardware_concurrency());
+
+    std::ifstream file(argv[1], std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto image = PE::Parse(bytes.data(), bytes.size());
+    auto mapped = PE::Map(bytes.data(), bytes.size());
+    if (!file || !image || !mapped) {
+        std::printf("%s is not a readable PE file\n", argv[1]);
+        return 2;
+    }
+
+    // Same regions ModuleRegions() builds from the mapped module in game
+    std::vector<Scanner::Region> regions;
+    for (const auto& section : image->sections) {
+        auto [offset, size] = image->Extent(section);
+        if (size)
+            regions.push_back({ section.name, mapped->data() + offset, size, section.IsExecutable() });
+    }
+    if (std::none_of(regions.begin(), regions.end(), [](const Scanner::Region& region) { return region.executable; }))
+        regions.push_back({ {}, mapped->data(), mapped->size(), true });
+
+    std::printf("Image: machine 0x%X, timestamp 0x%08X, %zu sections, %zuKB mapped\n",
+        image->machine, image->timestamp, image->sections.size(), mapped->size() >> 10);
+
+    // Absolute operands in the file hold addresses as if loaded at the preferred base
+    Resolve::Image target{ mapped->data(), mapped->size(), image->imageBase };
+
+    // The one pass the fix itself runs at startup
+    Scanner::Batch batch;
+    for (const auto& signature : GameSignatures::All)
+        batch.Add(signature.name, signature.signature);
+
+    auto batchStart = std::chrono::steady_clock::now();
+    batch.Scan(regions, threads);
+    auto batchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batchStart).count();
+    std::printf("Batch scan: %zu of %zu found in %.2fms on %u threads (%s)\n\n",
+        batch.Found(), batch.Size(), batchTime, threads, Scanner::KernelName(Scanner::BestKernel()));
+
+    // Then each signature on its own, counting every match rather than stopping at the first
+    int failures = 0;
+    std::printf("%-24s %-10s %-10s %-8s %s\n", "Signature", "Match", "Target", "Count", "Time");
+    for (const auto& signature : GameSignatures::All) {
+        Scanner::Pattern pattern(signature.signature);
+        const std::uint8_t* first = nullptr;
+        std::size_t count = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& region : regions) {
+            if (!region.executable)
+                continue;
+            auto data = region.data;
+            auto end = region.data + region.size;
+            while (auto match = Scanner::Find(data, static_cast<std::size_t>(end - data), pattern)) {
+                if (!first)
+                    first = match;
+                ++count;
+                data = match + 1;
+            }
+        }
+        auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto resolved = Resolve::Follow(signature.target, first, target);
+
+        const char* status = "";
+        if (count == 0)
+            status = "  MISSING";
+        else if (count > 1)
+            status = "  AMBIGUOUS";
+        else if (batch.Get(signature.name) != first)
+            status = "  BATCH MISMATCH";
+        else if (!resolved)
+            status = "  BAD TARGET";
+        if (*status)
+            ++failures;
+
+        if (first && resolved) {
+            auto rva = static_cast<std::uint32_t>(first - mapped->data());
+            auto targetRva = static_cast<std::uint32_t>(resolved.get() - mapped->data());
+            std::printf("%-24s 0x%08X 0x%08X %-8zu %.2fms%s\n", signature.name, rva, targetRva, count, time, status);
+        }
+        else if (first) {
+            auto rva = static_cast<std::uint32_t>(first - mapped->data());
+            std::printf("%-24s 0x%08X %-10s %-8zu %.2fms%s\n", signature.name, rva, "-", count, time, status);
+        }
+        else {
+            std::printf("%-24s %-10s %-10s %-8zu %.2fms%s\n", signature.name, "-", "-", count, time, status);
+        }
+    }
+
+    std::printf("\n%d of %zu signatures failed\n", failures, std::size(GameSignatures::All));
+    return failures ? 1 : 0;
+}
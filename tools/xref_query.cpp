@@ -0,0 +1,98 @@
+// Builds the cross-reference index over a game executable on disk and answers queries against it,
+// for finding constants and the code that uses them without writing a byte signature first.
+// Build from the repository root:
+//   cl /std:c++latest /O2 /EHsc /I src /I external\safetyhook tools\xref_query.cpp external\safetyhook\Zydis.c
+//   gcc -O2 -c external/safetyhook/Zydis.c -o Zydis.o
+//   g++ -std=c++20 -O2 -I src -I external/safetyhook tools/xref_query.cpp Zydis.o -o xref_query
+// Usage: xref_query <DDDA.exe> float <value>    e.g. float 720 or float 0.00078125
+//        xref_query <DDDA.exe> rva <hex>        what the instruction at rva references and who references rva
+// Exits with 1 if the query found nothing, 2 if the file can't be read.
+
+#include "pe.hpp"
+#include "resolve.hpp"
+#include "scanner.hpp"
+#include "xrefs.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        std::printf("Usage: %s <DDDA.exe> float <value> | rva <hex>\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto image = PE::Parse(bytes.data(), bytes.size());
+    auto mapped = PE::Map(bytes.data(), bytes.size());
+    if (!file || !image || !mapped) {
+        std::printf("%s is not a readable PE file\n", argv[1]);
+        return 2;
+    }
+
+    std::vector<Scanner::Region> regions;
+    for (const auto& section : image->sections) {
+        auto [offset, size] = image->Extent(section);
+        if (size)
+            regions.push_back({ section.name, mapped->data() + offset, size, section.IsExecutable() });
+    }
+    if (std::none_of(regions.begin(), regions.end(), [](const Scanner::Region& region) { return region.executable; }))
+        regions.push_back({ {}, mapped->data(), mapped->size(), true });
+
+    // Absolute operands in the file hold addresses as if loaded at the preferred base
+    Xrefs::Index index;
+    auto start = std::chrono::steady_clock::now();
+    if (!index.Build(regions, { mapped->data(), mapped->size(), image->imageBase })) {
+        std::printf("Failed to initialize the decoder\n");
+        return 2;
+    }
+    auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("Index: %zu references in %.2fms\n\n", index.Size(), time);
+
+    auto rva = [&](const std::uint8_t* address) { return static_cast<std::uint32_t>(address - mapped->data()); };
+    auto print = [&](const Xrefs::Reference& reference) {
+        std::printf("  0x%08X -> 0x%08X  %s at +%u\n", rva(reference.instruction), rva(reference.target),
+            reference.kind == Xrefs::Kind::Memory ? "memory" : "immediate", reference.operandOffset);
+    };
+
+    std::string query = argv[2];
+    if (query == "float") {
+        auto value = std::stof(argv[3]);
+        auto constants = index.Constants(value);
+        for (auto constant : constants) {
+            auto users = index.To(constant);
+            std::printf("%g at 0x%08X, %zu references\n", value, rva(constant), users.size());
+            for (const auto& reference : users)
+                print(reference);
+        }
+        if (constants.empty())
+            std::printf("No referenced %g found\n", value);
+        return constants.empty() ? 1 : 0;
+    }
+
+    if (query == "rva") {
+        auto address = static_cast<std::size_t>(std::stoul(argv[3], nullptr, 16));
+        if (address >= mapped->size()) {
+            std::printf("0x%zX is outside the image\n", address);
+            return 1;
+        }
+
+        auto from = index.From(mapped->data() + address);
+        auto to = index.To(mapped->data() + address);
+        std::printf("0x%08zX references %zu addresses\n", address, from.size());
+        for (const auto& reference : from)
+            print(reference);
+        std::printf("0x%08zX is referenced by %zu instructions\n", address, to.size());
+        for (const auto& reference : to)
+            print(reference);
+        return from.empty() && to.empty() ? 1 : 0;
+    }
+
+    std::printf("Unknown query %s\n", query.c_str());
+    return 2;
+}